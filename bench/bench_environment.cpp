@@ -0,0 +1,54 @@
+#include <pch.hpp>
+
+#include "bench_environment.hpp"
+#include <cstdlib>
+
+BenchEnvironment::Setup::Setup()
+{
+#if defined(GAME_PLATFORM_LINUX)
+    setenv("LIBGL_ALWAYS_SOFTWARE", "1", 0);
+#endif
+    ImGui::CreateContext();
+}
+
+BenchEnvironment::Setup::~Setup()
+{
+    ImGui::DestroyContext();
+}
+
+BenchEnvironment::BenchEnvironment()
+    : window(Engine::WindowMode::Headless), shader(resource_manager.load<Engine::Shader>("test.shader"))
+{
+
+}
+
+BenchEnvironment& BenchEnvironment::get()
+{
+    static BenchEnvironment environment;
+    return environment;
+}
+
+Engine::Window& BenchEnvironment::getWindow()
+{
+    return window;
+}
+
+Engine::ResourceManager& BenchEnvironment::getResourceManager()
+{
+    return resource_manager;
+}
+
+const Engine::Shader& BenchEnvironment::getShader()
+{
+    return shader;
+}
+
+Engine::JobSystem& BenchEnvironment::getJobs()
+{
+    return jobs;
+}
+
+Engine::FixedTimestep& BenchEnvironment::getTimestep()
+{
+    return timestep;
+}
@@ -0,0 +1,43 @@
+#pragma once
+
+#include "constructors.hpp"
+#include "engine/jobs/job_system.hpp"
+#include "engine/timestep.hpp"
+#include "gfx/window.hpp"
+#include "resource/resource_manager.hpp"
+#include "resource/shader.hpp"
+
+// Engine objects shared by benchmarks that need a window or GL context, created on first
+// use and kept for the whole run. Uses a headless window and defaults to Mesa's software
+// rasterizer so it works on machines without a display or GPU, setting SDL_VIDEODRIVER or
+// LIBGL_ALWAYS_SOFTWARE in the environment overrides either.
+
+class BenchEnvironment {
+public:
+    static BenchEnvironment& get();
+
+    DELETE_COPY(BenchEnvironment);
+    DELETE_MOVE(BenchEnvironment);
+
+    Engine::Window& getWindow();
+    Engine::ResourceManager& getResourceManager();
+    const Engine::Shader& getShader();
+    Engine::JobSystem& getJobs();
+    Engine::FixedTimestep& getTimestep();
+
+private:
+    // Has to run before the window initializes SDL and ImGui
+    struct Setup {
+        Setup();
+        ~Setup();
+    };
+
+    BenchEnvironment();
+
+    Setup setup;
+    Engine::Window window;
+    Engine::ResourceManager resource_manager;
+    const Engine::Shader& shader;
+    Engine::JobSystem jobs;
+    Engine::FixedTimestep timestep;
+};
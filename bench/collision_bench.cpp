@@ -0,0 +1,80 @@
+#include <pch.hpp>
+
+#include "bench_environment.hpp"
+#include "engine/collision.hpp"
+#include "engine/sprite.hpp"
+#include <benchmark/benchmark.h>
+#include <random>
+
+// Colliders spread over a 4000 unit square so a fair number of them touch, every
+// iteration moves all of them a little and steps the world. Items processed is colliders.
+
+constexpr float WORLD_SIZE = 4000.f;
+constexpr float HALF_SIZE = 16.f;
+
+static std::vector<float> randomPositions(size_t count, uint32_t seed)
+{
+    std::mt19937 rng(seed);
+    std::uniform_real_distribution<float> position(-WORLD_SIZE / 2, WORLD_SIZE / 2);
+    std::vector<float> positions(count * 2);
+    for (float& value : positions) {
+        value = position(rng);
+    }
+    return positions;
+}
+
+static void BM_CollisionStepAllMoving(benchmark::State& state)
+{
+    auto& environment = BenchEnvironment::get();
+    Engine::SpriteManager sprite_manager(environment.getShader(), environment.getJobs());
+    Engine::CollisionWorld collision(sprite_manager);
+    const auto count = static_cast<size_t>(state.range(0));
+    Engine::SpriteBatch batch = sprite_manager.createSprites(count);
+    for (size_t i = 0; i < count; i++) {
+        const Engine::Collider collider = i % 2 == 0
+            ? Engine::Collider { .shape = Engine::ColliderShape::Box, .half_extents = glm::vec2(HALF_SIZE, HALF_SIZE) }
+            : Engine::Collider { .shape = Engine::ColliderShape::Circle, .radius = HALF_SIZE };
+        collision.setCollider(batch.get(i).getId(), collider);
+    }
+
+    // Two layouts a few units apart, so pairs near the edge keep starting and ending
+    std::vector<float> positions = randomPositions(count, 1234);
+    std::vector<float> shifted = positions;
+    for (float& value : shifted) {
+        value += 3.f;
+    }
+
+    bool flip = false;
+    for (auto _ : state) {
+        batch.setPositions(flip ? shifted : positions);
+        flip = !flip;
+        collision.step();
+        benchmark::DoNotOptimize(collision.getEvents().data());
+        collision.clearEvents();
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+    state.counters["contacts"] = static_cast<double>(collision.getContactCount());
+}
+BENCHMARK(BM_CollisionStepAllMoving)->Arg(1024)->Arg(10000)->Arg(65536);
+
+// Nothing moved, a step should cost next to nothing however many colliders there are
+static void BM_CollisionStepIdle(benchmark::State& state)
+{
+    auto& environment = BenchEnvironment::get();
+    Engine::SpriteManager sprite_manager(environment.getShader(), environment.getJobs());
+    Engine::CollisionWorld collision(sprite_manager);
+    const auto count = static_cast<size_t>(state.range(0));
+    Engine::SpriteBatch batch = sprite_manager.createSprites(count);
+    batch.setPositions(randomPositions(count, 1234));
+    for (size_t i = 0; i < count; i++) {
+        collision.setCollider(batch.get(i).getId(), Engine::Collider {});
+    }
+    collision.step();
+    collision.clearEvents();
+
+    for (auto _ : state) {
+        collision.step();
+        benchmark::DoNotOptimize(collision.getEvents().data());
+    }
+}
+BENCHMARK(BM_CollisionStepIdle)->Arg(10000);
@@ -0,0 +1,85 @@
+#include <pch.hpp>
+
+#include "engine/ecs.hpp"
+#include <benchmark/benchmark.h>
+
+// Plain data components, nothing else from the engine is involved
+
+struct BenchPosition {
+    float x = 0.f;
+    float y = 0.f;
+};
+
+struct BenchVelocity {
+    float x = 1.f;
+    float y = 1.f;
+};
+
+// Every entity has a position, one in every given number also has a velocity
+static Engine::EntityRegistry makeRegistry(size_t count, size_t velocity_every)
+{
+    Engine::EntityRegistry registry;
+    for (size_t i = 0; i < count; i++) {
+        const Engine::Entity entity = registry.create();
+        registry.emplace<BenchPosition>(entity);
+        if (i % velocity_every == 0) {
+            registry.emplace<BenchVelocity>(entity);
+        }
+    }
+    return registry;
+}
+
+// One pool straight through, as close to a loop over a plain array as the view gets
+static void BM_ViewSingle(benchmark::State& state)
+{
+    Engine::EntityRegistry registry = makeRegistry(static_cast<size_t>(state.range(0)), 1);
+
+    for (auto _ : state) {
+        registry.view<BenchPosition>().each([](Engine::Entity, BenchPosition& position) {
+            position.x += 1.f;
+        });
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_ViewSingle)->Arg(1 << 14)->Arg(1 << 17);
+
+// Two components, the second argument is how sparse the velocities are. Items processed is
+// every entity with a position, most of which get skipped when velocities are rare.
+static void BM_ViewPair(benchmark::State& state)
+{
+    Engine::EntityRegistry registry = makeRegistry(static_cast<size_t>(state.range(0)), static_cast<size_t>(state.range(1)));
+
+    for (auto _ : state) {
+        registry.view<BenchPosition, BenchVelocity>().each([](Engine::Entity, BenchPosition& position, const BenchVelocity& velocity) {
+            position.x += velocity.x;
+            position.y += velocity.y;
+        });
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_ViewPair)
+    ->ArgsProduct({ { 1 << 14, 1 << 17 }, { 1, 16 } })
+    ->ArgNames({ "entities", "velocity_every" });
+
+// Creating entities with two components and destroying them again
+static void BM_CreateDestroy(benchmark::State& state)
+{
+    const auto count = static_cast<size_t>(state.range(0));
+    Engine::EntityRegistry registry;
+    std::vector<Engine::Entity> entities(count);
+
+    for (auto _ : state) {
+        for (Engine::Entity& entity : entities) {
+            entity = registry.create();
+            registry.emplace<BenchPosition>(entity);
+            registry.emplace<BenchVelocity>(entity);
+        }
+        for (const Engine::Entity entity : entities) {
+            registry.destroy(entity);
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_CreateDestroy)->Arg(1 << 14);
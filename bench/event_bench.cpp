@@ -0,0 +1,45 @@
+#include <pch.hpp>
+
+#include "engine/event.hpp"
+#include <benchmark/benchmark.h>
+
+// Cost of Event::fire from C++ into Lua, per listener
+static void BM_EventFire(benchmark::State& state)
+{
+    sol::state lua;
+    lua.open_libraries(sol::lib::base);
+    sol::protected_function listener = lua.script("return function(delta_time) end");
+
+    Engine::Event event;
+    std::vector<Engine::EventConnection> connections;
+    for (int64_t i = 0; i < state.range(0); i++) {
+        connections.push_back(event.connect(listener));
+    }
+
+    for (auto _ : state) {
+        event.fire(0.016f);
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_EventFire)->Arg(1)->Arg(64)->Arg(1024);
+
+// Listener that does some work, closer to a real OnFixedStep handler
+static void BM_EventFireAccumulate(benchmark::State& state)
+{
+    sol::state lua;
+    lua.open_libraries(sol::lib::base);
+    lua.script("total = 0");
+    sol::protected_function listener = lua.script("return function(delta_time) total = total + delta_time end");
+
+    Engine::Event event;
+    std::vector<Engine::EventConnection> connections;
+    for (int64_t i = 0; i < state.range(0); i++) {
+        connections.push_back(event.connect(listener));
+    }
+
+    for (auto _ : state) {
+        event.fire(0.016f);
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_EventFireAccumulate)->Arg(64)->Arg(1024);
@@ -0,0 +1,81 @@
+#include <pch.hpp>
+
+#include "engine/jobs/job_system.hpp"
+#include <benchmark/benchmark.h>
+#include <cmath>
+
+// Cost of pushing a trivial job through the queues and waiting on it
+static void BM_JobScheduleWait(benchmark::State& state)
+{
+    Engine::JobSystem jobs(static_cast<size_t>(state.range(0)));
+    for (auto _ : state) {
+        Engine::JobCounter counter;
+        jobs.schedule([]() {}, &counter);
+        jobs.wait(counter);
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_JobScheduleWait)->Arg(1)->Arg(4);
+
+// Many tiny jobs at once, measures queue contention and stealing
+static void BM_JobScheduleBatch(benchmark::State& state)
+{
+    Engine::JobSystem jobs;
+    const auto batch = static_cast<size_t>(state.range(0));
+    for (auto _ : state) {
+        Engine::JobCounter counter;
+        for (size_t i = 0; i < batch; i++) {
+            jobs.schedule([]() {}, &counter);
+        }
+        jobs.wait(counter);
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_JobScheduleBatch)->Arg(64)->Arg(1024)->Arg(16384);
+
+static void BM_JobDependencyChain(benchmark::State& state)
+{
+    Engine::JobSystem jobs;
+    const auto length = static_cast<size_t>(state.range(0));
+    for (auto _ : state) {
+        std::vector<std::unique_ptr<Engine::JobCounter>> counters;
+        for (size_t i = 0; i < length; i++) {
+            counters.push_back(std::make_unique<Engine::JobCounter>());
+            Engine::JobCounter* dependency = i > 0 ? counters[i - 1].get() : nullptr;
+            jobs.schedule([]() {}, counters[i].get(), dependency);
+        }
+        jobs.wait(*counters.back());
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_JobDependencyChain)->Arg(16)->Arg(256);
+
+// Scaling of a compute bound parallelFor with the number of workers
+static void BM_ParallelForScaling(benchmark::State& state)
+{
+    Engine::JobSystem jobs(static_cast<size_t>(state.range(0)));
+    std::vector<float> values(1 << 20, 1.f);
+    for (auto _ : state) {
+        jobs.parallelFor(0, values.size(), 16384, [&values](size_t begin, size_t end) {
+            for (size_t i = begin; i < end; i++) {
+                values[i] = std::sqrt(values[i] * 1.0001f + 0.5f);
+            }
+        });
+        benchmark::DoNotOptimize(values.data());
+    }
+    state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(values.size()));
+}
+BENCHMARK(BM_ParallelForScaling)->RangeMultiplier(2)->Range(1, 16)->UseRealTime();
+
+static void BM_SerialForBaseline(benchmark::State& state)
+{
+    std::vector<float> values(1 << 20, 1.f);
+    for (auto _ : state) {
+        for (size_t i = 0; i < values.size(); i++) {
+            values[i] = std::sqrt(values[i] * 1.0001f + 0.5f);
+        }
+        benchmark::DoNotOptimize(values.data());
+    }
+    state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(values.size()));
+}
+BENCHMARK(BM_SerialForBaseline)->UseRealTime();
@@ -0,0 +1,37 @@
+#include <pch.hpp>
+
+#include "bench_environment.hpp"
+#include "engine/ecs.hpp"
+#include "engine/kinematics.hpp"
+#include "engine/sprite.hpp"
+#include <benchmark/benchmark.h>
+
+// A full fixed step of the movement system, gathering from the pools, both kernels and
+// the write back into the sprites. Every body is accelerating so every sprite moves.
+static void BM_KinematicsStep(benchmark::State& state)
+{
+    auto& environment = BenchEnvironment::get();
+    Engine::SpriteManager sprite_manager(environment.getShader(), environment.getJobs());
+    Engine::EntityRegistry registry;
+    Engine::KinematicsSystem kinematics(registry, sprite_manager);
+
+    const auto count = static_cast<size_t>(state.range(0));
+    for (size_t i = 0; i < count; i++) {
+        const Engine::Entity entity = registry.create();
+        registry.emplace<Engine::Sprite>(entity, sprite_manager.createSprite());
+        registry.emplace<Engine::Kinematics>(entity, Engine::Kinematics {
+            .acceleration = glm::vec2(static_cast<float>(i % 7) - 3.f, 1.f) * 1000.f,
+            .damping = 10.f,
+            .max_speed = 100.f,
+        });
+    }
+
+    for (auto _ : state) {
+        sprite_manager.beginFixedStep();
+        kinematics.step(1.f / 60.f);
+        sprite_manager.endFixedStep();
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_KinematicsStep)->Arg(1024)->Arg(16384)->Arg(131072);
@@ -0,0 +1,75 @@
+#include <pch.hpp>
+
+#include <benchmark/benchmark.h>
+#include <iostream>
+#include <streambuf>
+
+// Logger writes to std::cout, which gets pointed at a sink that drops everything so the
+// numbers are formatting and stream overhead rather than the terminal
+
+class NullBuffer : public std::streambuf {
+protected:
+    int overflow(int c) override
+    {
+        return c;
+    }
+
+    std::streamsize xsputn(const char*, std::streamsize count) override
+    {
+        return count;
+    }
+};
+
+class DiscardStdout {
+public:
+    DiscardStdout()
+        : previous(std::cout.rdbuf(&buffer))
+    {
+
+    }
+
+    ~DiscardStdout()
+    {
+        std::cout.rdbuf(previous);
+    }
+
+private:
+    NullBuffer buffer;
+    std::streambuf* previous;
+};
+
+static void BM_LogPlainMessage(benchmark::State& state)
+{
+    DiscardStdout discard;
+    for (auto _ : state) {
+        Engine::Log::info("Plain message without arguments");
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_LogPlainMessage);
+
+static void BM_LogFormattedMessage(benchmark::State& state)
+{
+    DiscardStdout discard;
+    int64_t frame = 0;
+    for (auto _ : state) {
+        Engine::Log::info("Frame {} took {:.2f} ms with {} sprites", frame++, 16.6f, 16384);
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_LogFormattedMessage);
+
+// Below the category's runtime level, should be about the cost of a relaxed load
+static void BM_LogFilteredMessage(benchmark::State& state)
+{
+    DiscardStdout discard;
+    const auto previous = Engine::Log::GLOBAL_LOGGER.getLevel(Engine::Log::Category::Render);
+    Engine::Log::GLOBAL_LOGGER.setLevel(Engine::Log::Category::Render, Engine::Log::Logger::Severity::Warning);
+    int64_t frame = 0;
+    for (auto _ : state) {
+        Engine::Log::info(Engine::Log::Category::Render, "Frame {} took {:.2f} ms with {} sprites", frame++, 16.6f, 16384);
+    }
+    Engine::Log::GLOBAL_LOGGER.setLevel(Engine::Log::Category::Render, previous);
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_LogFilteredMessage);
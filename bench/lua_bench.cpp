@@ -0,0 +1,31 @@
+#include <pch.hpp>
+
+#include "bench_environment.hpp"
+#include "engine/lua.hpp"
+#include "engine/sprite.hpp"
+#include "engine/collision.hpp"
+#include "engine/ecs.hpp"
+#include "resource/lua_source.hpp"
+#include <benchmark/benchmark.h>
+
+// Runs resources/bench/vec2_math.lua through the real bindings, every fire does 100
+// iterations of Vec2 construction, arithmetic, Length and Normalize
+static void BM_LuaVec2Math(benchmark::State& state)
+{
+    auto& environment = BenchEnvironment::get();
+    Engine::SpriteManager sprite_manager(environment.getShader(), environment.getJobs());
+    Engine::CollisionWorld collision(sprite_manager);
+    Engine::EntityRegistry registry;
+    Engine::Camera camera;
+    Engine::Lua lua(sprite_manager, collision, registry, environment.getResourceManager(), camera, environment.getTimestep(), environment.getWindow());
+    lua.registerTypes<glm::vec2, Engine::Event, Engine::EventConnection>();
+    lua.runEntryPoint(environment.getResourceManager().load<Engine::LuaSource>("bench/vec2_math.lua"));
+
+    for (auto _ : state) {
+        lua.fireBuiltinEvent("OnFrameStep", 0.016f);
+    }
+    state.SetItemsProcessed(state.iterations() * 100);
+
+    lua.gc();
+}
+BENCHMARK(BM_LuaVec2Math);
@@ -0,0 +1,74 @@
+#include <pch.hpp>
+
+#include "gfx/render_queue.hpp"
+#include <algorithm>
+#include <benchmark/benchmark.h>
+#include <random>
+
+// Sorting only, nothing here touches GL. Commands spread over a few layers, shaders and
+// textures with random depths, which is the shape a busy frame would have.
+
+static std::vector<Engine::DrawCommand> makeCommands(size_t count)
+{
+    std::mt19937 rng(1234);
+    std::uniform_int_distribution<unsigned int> layer(0, 3);
+    std::uniform_int_distribution<unsigned int> shader(1, 4);
+    std::uniform_int_distribution<unsigned int> texture(1, 16);
+    std::uniform_real_distribution<float> depth(-100.f, 100.f);
+
+    std::vector<Engine::DrawCommand> commands(count);
+    for (auto& command : commands) {
+        command.program = shader(rng);
+        command.texture = texture(rng);
+        command.key = Engine::makeSortKey(Engine::SortKeyFields {
+            .layer = static_cast<uint8_t>(layer(rng)),
+            .shader = command.program,
+            .texture = command.texture,
+            .depth = depth(rng),
+        });
+    }
+    return commands;
+}
+
+static void BM_RenderQueueRadixSort(benchmark::State& state)
+{
+    const auto commands = makeCommands(static_cast<size_t>(state.range(0)));
+    Engine::RenderQueue queue;
+
+    for (auto _ : state) {
+        state.PauseTiming();
+        for (const auto& command : commands) {
+            queue.submit(command);
+        }
+        state.ResumeTiming();
+
+        queue.sort();
+        benchmark::DoNotOptimize(queue.getCommands().data());
+
+        state.PauseTiming();
+        queue.clear();
+        state.ResumeTiming();
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_RenderQueueRadixSort)->Arg(1 << 8)->Arg(1 << 12)->Arg(1 << 16);
+
+// Baseline to compare the radix sort against
+static void BM_RenderQueueStdSort(benchmark::State& state)
+{
+    const auto commands = makeCommands(static_cast<size_t>(state.range(0)));
+    std::vector<Engine::DrawCommand> sorted;
+
+    for (auto _ : state) {
+        state.PauseTiming();
+        sorted = commands;
+        state.ResumeTiming();
+
+        std::stable_sort(sorted.begin(), sorted.end(), [](const auto& lhs, const auto& rhs) {
+            return lhs.key < rhs.key;
+        });
+        benchmark::DoNotOptimize(sorted.data());
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_RenderQueueStdSort)->Arg(1 << 8)->Arg(1 << 12)->Arg(1 << 16);
@@ -0,0 +1,30 @@
+#include <pch.hpp>
+
+#include "resource/lua_source.hpp"
+#include "resource/resource_manager.hpp"
+#include <benchmark/benchmark.h>
+
+// Lookups by path with a given number of loaded resources. Every entry is main.lua under
+// a different "./" prefix so they're all distinct keys without needing extra files.
+static void BM_ResourceLookup(benchmark::State& state)
+{
+    Engine::ResourceManager resource_manager;
+    std::vector<std::filesystem::path> paths;
+    for (int64_t i = 0; i < state.range(0); i++) {
+        std::string path;
+        for (int64_t j = 0; j < i; j++) {
+            path += "./";
+        }
+        paths.push_back(path + "main.lua");
+        resource_manager.load<Engine::LuaSource>(paths.back());
+    }
+
+    size_t next = 0;
+    for (auto _ : state) {
+        const auto& source = resource_manager.get<Engine::LuaSource>(paths[next]);
+        benchmark::DoNotOptimize(&source);
+        next = (next + 1) % paths.size();
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_ResourceLookup)->Arg(1)->Arg(16)->Arg(256);
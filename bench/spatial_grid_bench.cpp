@@ -0,0 +1,110 @@
+#include <pch.hpp>
+
+#include "engine/spatial_grid.hpp"
+#include <benchmark/benchmark.h>
+#include <random>
+
+// Grid maintenance and queries on their own, no sprites or GL. The world is 20000 units
+// across, roughly ten screens each way, and queries are about a screen in size.
+
+constexpr float WORLD_SIZE = 20000.f;
+constexpr float HALF_SIZE = 50.f;
+
+static std::vector<glm::vec2> randomPositions(size_t count, uint32_t seed = 1234)
+{
+    std::mt19937 rng(seed);
+    std::uniform_real_distribution<float> position(-WORLD_SIZE / 2, WORLD_SIZE / 2);
+    std::vector<glm::vec2> positions(count);
+    for (auto& value : positions) {
+        value = glm::vec2(position(rng), position(rng));
+    }
+    return positions;
+}
+
+static Engine::SpatialGrid makeGrid(const std::vector<glm::vec2>& positions)
+{
+    Engine::SpatialGrid grid;
+    for (size_t i = 0; i < positions.size(); i++) {
+        grid.update(i, positions[i], HALF_SIZE);
+    }
+    return grid;
+}
+
+// Every sprite moves by the given distance per iteration, small steps mostly stay within a
+// cell while large ones nearly always change cells. Items processed is moved sprites.
+static void BM_SpatialGridUpdate(benchmark::State& state)
+{
+    const auto count = static_cast<size_t>(state.range(0));
+    const float step = static_cast<float>(state.range(1));
+    std::vector<glm::vec2> positions = randomPositions(count);
+    Engine::SpatialGrid grid = makeGrid(positions);
+
+    float direction = 1.f;
+    for (auto _ : state) {
+        for (size_t i = 0; i < count; i++) {
+            positions[i].x += step * direction;
+            grid.update(i, positions[i], HALF_SIZE);
+        }
+        direction = -direction;
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_SpatialGridUpdate)
+    ->ArgsProduct({ { 1 << 14, 1 << 17 }, { 2, 300 } })
+    ->ArgNames({ "sprites", "step" });
+
+static const Engine::SpriteBounds QUERY_RECT {
+    .min = glm::vec2(-960.f, -540.f),
+    .max = glm::vec2(960.f, 540.f),
+};
+
+static void BM_SpatialGridQueryRect(benchmark::State& state)
+{
+    const auto count = static_cast<size_t>(state.range(0));
+    const Engine::SpatialGrid grid = makeGrid(randomPositions(count));
+    std::vector<Engine::SpriteId> found;
+
+    for (auto _ : state) {
+        found.clear();
+        grid.query(QUERY_RECT, found);
+        benchmark::DoNotOptimize(found.data());
+    }
+    state.counters["found"] = static_cast<double>(found.size());
+}
+BENCHMARK(BM_SpatialGridQueryRect)->Arg(1 << 14)->Arg(1 << 17);
+
+// Same query done the way a script would have to without the index
+static void BM_BruteForceQueryRect(benchmark::State& state)
+{
+    const auto count = static_cast<size_t>(state.range(0));
+    const std::vector<glm::vec2> positions = randomPositions(count);
+    std::vector<Engine::SpriteId> found;
+
+    for (auto _ : state) {
+        found.clear();
+        for (size_t i = 0; i < count; i++) {
+            const Engine::SpriteBounds bounds { positions[i] - HALF_SIZE, positions[i] + HALF_SIZE };
+            if (bounds.overlaps(QUERY_RECT)) {
+                found.push_back(i);
+            }
+        }
+        benchmark::DoNotOptimize(found.data());
+    }
+    state.counters["found"] = static_cast<double>(found.size());
+}
+BENCHMARK(BM_BruteForceQueryRect)->Arg(1 << 14)->Arg(1 << 17);
+
+static void BM_SpatialGridQueryRadius(benchmark::State& state)
+{
+    const auto count = static_cast<size_t>(state.range(0));
+    const Engine::SpatialGrid grid = makeGrid(randomPositions(count));
+    std::vector<Engine::SpriteId> found;
+
+    for (auto _ : state) {
+        found.clear();
+        grid.query(glm::vec2(0.f, 0.f), 500.f, found);
+        benchmark::DoNotOptimize(found.data());
+    }
+    state.counters["found"] = static_cast<double>(found.size());
+}
+BENCHMARK(BM_SpatialGridQueryRadius)->Arg(1 << 14)->Arg(1 << 17);
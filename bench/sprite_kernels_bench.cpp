@@ -0,0 +1,116 @@
+#include <pch.hpp>
+
+#include "engine/sprite_kernels.hpp"
+#include <benchmark/benchmark.h>
+#include <random>
+
+// Every kernel level is benchmarked whether or not it is the one picked at runtime, items
+// processed is in sprites so the counters read as throughput per sprite
+
+static Engine::SpriteColumns makeSprites(size_t count)
+{
+    std::mt19937 rng(1234);
+    std::uniform_real_distribution<float> position(-2000.f, 2000.f);
+    std::uniform_real_distribution<float> scale(0.5f, 2.f);
+
+    Engine::SpriteColumns sprites;
+    for (size_t i = 0; i < count; i++) {
+        sprites.push(glm::vec2(position(rng), position(rng)), scale(rng));
+    }
+    return sprites;
+}
+
+static const Engine::SpriteKernels& kernelsFor(const benchmark::State& state)
+{
+    return Engine::getSpriteKernels(static_cast<Engine::SimdLevel>(state.range(0)));
+}
+
+static void kernelArgs(benchmark::internal::Benchmark* bench)
+{
+    for (auto level : { Engine::SimdLevel::Scalar, Engine::SimdLevel::SSE2, Engine::SimdLevel::AVX2 }) {
+        if (level > Engine::detectSimdLevel()) {
+            continue;
+        }
+        for (int64_t count : { 1 << 10, 1 << 14, 1 << 17 }) {
+            bench->Args({ static_cast<int64_t>(level), count });
+        }
+    }
+    bench->ArgNames({ "level", "sprites" });
+}
+
+static void BM_SpritePack(benchmark::State& state)
+{
+    const auto& kernels = kernelsFor(state);
+    const auto count = static_cast<size_t>(state.range(1));
+    const auto sprites = makeSprites(count);
+    std::vector<Engine::SpriteInstanceData> out(count);
+
+    state.SetLabel(kernels.name);
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(kernels.pack(sprites, 0, count, 0.5f, out.data()));
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(1));
+    state.SetBytesProcessed(state.iterations() * static_cast<int64_t>(out.size() * sizeof(Engine::SpriteInstanceData)));
+}
+BENCHMARK(BM_SpritePack)->Apply(kernelArgs);
+
+static void BM_SpriteIntegrate(benchmark::State& state)
+{
+    const auto& kernels = kernelsFor(state);
+    const auto count = static_cast<size_t>(state.range(1));
+    auto sprites = makeSprites(count);
+    const std::vector<float> velocity_x(count, 3.f);
+    const std::vector<float> velocity_y(count, -2.f);
+
+    state.SetLabel(kernels.name);
+    for (auto _ : state) {
+        kernels.integrate(sprites.x.data(), sprites.y.data(), velocity_x.data(), velocity_y.data(), count, 1.f / 60.f);
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(1));
+}
+BENCHMARK(BM_SpriteIntegrate)->Apply(kernelArgs);
+
+// Half the velocities end up over their max speed and get clamped
+static void BM_SpriteAccelerate(benchmark::State& state)
+{
+    const auto& kernels = kernelsFor(state);
+    const auto count = static_cast<size_t>(state.range(1));
+    std::vector<float> velocity_x(count, 50.f);
+    std::vector<float> velocity_y(count, -20.f);
+    const std::vector<float> acceleration_x(count, 3000.f);
+    const std::vector<float> acceleration_y(count, 0.f);
+    const std::vector<float> damping(count, 10.f);
+    std::vector<float> max_speed(count, 100.f);
+    for (size_t i = 0; i < count; i += 2) {
+        max_speed[i] = 1000.f;
+    }
+
+    state.SetLabel(kernels.name);
+    for (auto _ : state) {
+        kernels.accelerate(
+            velocity_x.data(), velocity_y.data(),
+            acceleration_x.data(), acceleration_y.data(),
+            damping.data(), max_speed.data(),
+            count, 1.f / 60.f
+        );
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(1));
+}
+BENCHMARK(BM_SpriteAccelerate)->Apply(kernelArgs);
+
+static void BM_SpriteBounds(benchmark::State& state)
+{
+    const auto& kernels = kernelsFor(state);
+    const auto count = static_cast<size_t>(state.range(1));
+    const auto sprites = makeSprites(count);
+
+    state.SetLabel(kernels.name);
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(kernels.bounds(sprites, 0, count));
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(1));
+}
+BENCHMARK(BM_SpriteBounds)->Apply(kernelArgs);
@@ -0,0 +1,77 @@
+#include <pch.hpp>
+
+#include "bench_environment.hpp"
+#include "engine/pipeline.hpp"
+#include "engine/sprite.hpp"
+#include <benchmark/benchmark.h>
+#include <random>
+
+// Full SpriteManager::pack including dirty tracking and buffer recycling, as opposed to
+// the raw kernels in sprite_kernels_bench
+
+static std::vector<float> randomPositions(size_t count)
+{
+    std::mt19937 rng(1234);
+    std::uniform_real_distribution<float> position(-2000.f, 2000.f);
+    std::vector<float> positions(count * 2);
+    for (float& value : positions) {
+        value = position(rng);
+    }
+    return positions;
+}
+
+// Every sprite moved since the last pack
+static void BM_SpritePackAllDirty(benchmark::State& state)
+{
+    auto& environment = BenchEnvironment::get();
+    Engine::SpriteManager sprite_manager(environment.getShader(), environment.getJobs());
+    const auto count = static_cast<size_t>(state.range(0));
+    Engine::SpriteBatch batch = sprite_manager.createSprites(count);
+    const std::vector<float> positions = randomPositions(count);
+
+    Engine::RenderSnapshot snapshot;
+    for (auto _ : state) {
+        batch.setPositions(positions);
+        sprite_manager.pack(snapshot);
+        benchmark::DoNotOptimize(snapshot.sprite_instances.get());
+        snapshot.sprite_instances = nullptr;
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_SpritePackAllDirty)->Arg(1024)->Arg(16384)->Arg(131072)->UseRealTime();
+
+// Sprites between two fixed steps, repacked every frame for interpolation
+static void BM_SpritePackInterpolating(benchmark::State& state)
+{
+    auto& environment = BenchEnvironment::get();
+    Engine::SpriteManager sprite_manager(environment.getShader(), environment.getJobs());
+    const auto count = static_cast<size_t>(state.range(0));
+    Engine::SpriteBatch batch = sprite_manager.createSprites(count);
+    sprite_manager.beginFixedStep();
+    batch.setPositions(randomPositions(count));
+
+    Engine::RenderSnapshot snapshot;
+    for (auto _ : state) {
+        sprite_manager.pack(snapshot, 0.5f);
+        benchmark::DoNotOptimize(snapshot.sprite_instances.get());
+        snapshot.sprite_instances = nullptr;
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_SpritePackInterpolating)->Arg(1024)->Arg(16384)->Arg(131072)->UseRealTime();
+
+// Nothing changed, should only hand out the previously packed buffer
+static void BM_SpritePackUnchanged(benchmark::State& state)
+{
+    auto& environment = BenchEnvironment::get();
+    Engine::SpriteManager sprite_manager(environment.getShader(), environment.getJobs());
+    Engine::SpriteBatch batch = sprite_manager.createSprites(static_cast<size_t>(state.range(0)));
+
+    Engine::RenderSnapshot snapshot;
+    for (auto _ : state) {
+        sprite_manager.pack(snapshot);
+        benchmark::DoNotOptimize(snapshot.sprite_instances.get());
+        snapshot.sprite_instances = nullptr;
+    }
+}
+BENCHMARK(BM_SpritePackUnchanged)->Arg(16384);
@@ -0,0 +1,20 @@
+-- Used by game_bench, each OnFrameStep does a fixed amount of Vec2 math so the cost per
+-- call can be compared between builds
+
+local Engine = require("Engine")
+
+local ITERATIONS = 100
+
+local position = Vec2.new(0, 0)
+local velocity = Vec2.new(1, 2)
+
+Engine.Events.OnFrameStep:Connect(function (delta_time)
+    for _ = 1, ITERATIONS do
+        local acceleration = Vec2.new(0.5, -0.25)
+        if acceleration:Length() > 0 then
+            acceleration = acceleration:Normalize() * 30
+        end
+        velocity = velocity + acceleration * delta_time - velocity * 0.1 * delta_time
+        position = position + velocity * delta_time
+    end
+end)
@@ -3,44 +3,48 @@ local Test = require("other")
 
 Engine.SetVSync(false)
 
+local player = Engine.CreateEntity()
 local sprite = Engine.CreateSprite()
+local player_texture = Engine.LoadTexture("player.png")
+if player_texture then
+    sprite.texture = player_texture
+end
+
+-- The engine moves the sprite, the script only steers it
+Engine.SetComponent(player, "Sprite", sprite)
+Engine.SetComponent(player, "Kinematics", { damping = 10, max_speed = 100 })
+local body = Engine.GetComponent(player, "Kinematics")
 
-local velocity = Vec2.new(0, 0)
-local acceleration = Vec2.new(0, 0)
-local maxSpeed = 100
 local accelRate = 30
-local friction = 10
 
 print("Test");
 
-local frame_step = Engine.Events.OnFrameStep:Connect(function (delta_time)
-    acceleration = Vec2.new(0, 0)
+local fixed_step = Engine.Events.OnFixedStep:Connect(function (delta_time)
+    local x, y = 0, 0
 
     if Engine.IsKeyPressed(Engine.KeyCode.Up) then
-        acceleration = acceleration + Vec2.new(0, 1)
+        y = y + 1
     end
     if Engine.IsKeyPressed(Engine.KeyCode.Down) then
-        acceleration = acceleration + Vec2.new(0, -1)
+        y = y - 1
     end
     if Engine.IsKeyPressed(Engine.KeyCode.Left) then
-        acceleration = acceleration + Vec2.new(-1, 0)
+        x = x - 1
     end
     if Engine.IsKeyPressed(Engine.KeyCode.Right) then
-        acceleration = acceleration + Vec2.new(1, 0)
+        x = x + 1
     end
 
-    if acceleration:Length() > 0 then
-        acceleration = acceleration / acceleration:Length() * accelRate * 1000
+    local length = math.sqrt(x * x + y * y)
+    if length > 0 then
+        local scale = accelRate * 1000 / length
+        x, y = x * scale, y * scale
     end
 
-    local friction_force = velocity * -1 * friction
-    acceleration = acceleration + friction_force
-
-    velocity = velocity + acceleration * delta_time
-
-    if velocity:Length() > maxSpeed then
-        velocity = velocity:Normalize() * maxSpeed
-    end
+    body:SetAcceleration(x, y)
+end)
 
-    sprite.position = sprite.position + velocity * delta_time
+-- Following where the sprite is drawn rather than its last tick keeps it still on screen
+local frame_step = Engine.Events.OnFrameStep:Connect(function (delta_time)
+    Engine.Camera.position = sprite.render_position
 end)
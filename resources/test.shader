@@ -1,12 +1,13 @@
 #section vert
 
-layout(location = 0) in uint index;
-layout(location = 1) in vec2 position;
-layout(location = 2) in float scale;
+// Per instance, x, y, scale and atlas layer, then the UV rect as min and max corners
+layout(location = 0) in vec4 instance;
+layout(location = 1) in vec4 uv_rect;
 
 uniform mat4 projection;
 
 out vec4 vert_color;
+out vec3 vert_uv;
 
 void main()
 {
@@ -18,17 +19,28 @@ void main()
         vec2(-0.5, 0.5), 
         vec2(0.5, 0.5)
     );
-    vec4 scaled_pos = vec4((quad_verts[index] * scale * 100) + position, 0.0, 1.0);
+    vec2 corner = quad_verts[gl_VertexID];
+    vec2 position = instance.xy;
+    vec4 scaled_pos = vec4((corner * instance.z * 100) + position, 0.0, 1.0);
     gl_Position = projection * scaled_pos;
     vert_color = vec4(position.x / 700, position.y / 300, 0.2, 1.0);
+    // Images are stored top row first, the top of the quad gets v_min
+    vert_uv = vec3(mix(uv_rect.xy, uv_rect.zw, vec2(corner.x + 0.5, 0.5 - corner.y)), instance.w);
 }
 
 #section frag
 
+uniform sampler2DArray sprite_atlas;
+
 out vec4 FragColor;
 in vec4 vert_color;
+in vec3 vert_uv;
 
 void main()
 {
-    FragColor = vert_color;
+    if (vert_uv.z < 0.0) {
+        FragColor = vert_color;
+    } else {
+        FragColor = texture(sprite_atlas, vert_uv);
+    }
 }
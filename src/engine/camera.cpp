@@ -0,0 +1,64 @@
+#include <pch.hpp>
+
+#include "camera.hpp"
+#include <algorithm>
+#include <cmath>
+#include <glm/ext/matrix_clip_space.hpp>
+#include <glm/ext/matrix_transform.hpp>
+
+namespace Engine {
+
+void Camera::setPosition(glm::vec2 position)
+{
+    this->position = position;
+}
+
+glm::vec2 Camera::getPosition() const
+{
+    return position;
+}
+
+void Camera::setZoom(float zoom)
+{
+    this->zoom = std::max(zoom, MIN_ZOOM);
+}
+
+float Camera::getZoom() const
+{
+    return zoom;
+}
+
+void Camera::setRotation(float rotation)
+{
+    this->rotation = rotation;
+}
+
+float Camera::getRotation() const
+{
+    return rotation;
+}
+
+glm::mat4 Camera::getViewProjection(glm::vec2 viewport) const
+{
+    const glm::vec2 half_extent = viewport / (2.f * zoom);
+    const glm::mat4 projection = glm::ortho(-half_extent.x, half_extent.x, -half_extent.y, half_extent.y, -1.f, 1.f);
+    const glm::mat4 rotated = glm::rotate(glm::mat4(1.f), -rotation, glm::vec3(0.f, 0.f, 1.f));
+    return projection * glm::translate(rotated, glm::vec3(-position, 0.f));
+}
+
+SpriteBounds Camera::getVisibleBounds(glm::vec2 viewport) const
+{
+    const glm::vec2 half_extent = viewport / (2.f * zoom);
+    const float cos = std::abs(std::cos(rotation));
+    const float sin = std::abs(std::sin(rotation));
+    const glm::vec2 rotated_extent(
+        cos * half_extent.x + sin * half_extent.y,
+        sin * half_extent.x + cos * half_extent.y
+    );
+    return SpriteBounds {
+        .min = position - rotated_extent,
+        .max = position + rotated_extent,
+    };
+}
+
+} // namespace Engine
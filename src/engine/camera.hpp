@@ -0,0 +1,36 @@
+#pragma once
+
+#include "sprite_kernels.hpp"
+#include <glm/glm.hpp>
+
+namespace Engine {
+
+// 2D camera looking at position. Zoom above 1 magnifies, rotation is in radians and turns
+// the view counter clockwise. Lives on the simulation thread, the render thread only ever
+// sees the matrix it produces.
+
+class Camera {
+public:
+    constexpr static float MIN_ZOOM = 0.01f;
+
+    void setPosition(glm::vec2 position);
+    glm::vec2 getPosition() const;
+    // Clamped to MIN_ZOOM so the view never inverts or collapses
+    void setZoom(float zoom);
+    float getZoom() const;
+    void setRotation(float rotation);
+    float getRotation() const;
+
+    // Viewport is in pixels, one world unit is one pixel at zoom 1
+    glm::mat4 getViewProjection(glm::vec2 viewport) const;
+    // World space box around everything the viewport can show, rotated views get the box
+    // around the rotated rectangle
+    SpriteBounds getVisibleBounds(glm::vec2 viewport) const;
+
+private:
+    glm::vec2 position = glm::vec2(0.f, 0.f);
+    float zoom = 1.f;
+    float rotation = 0.f;
+};
+
+} // namespace Engine
@@ -0,0 +1,229 @@
+#include <pch.hpp>
+
+#include "collision.hpp"
+#include <algorithm>
+
+namespace Engine {
+
+CollisionWorld::CollisionWorld(SpriteManager& sprite_manager, float cell_size)
+    : sprite_manager(sprite_manager), broadphase(cell_size)
+{
+    changes = sprite_manager.addChangeListener();
+    // Ids are reused, the collider has to go before a new sprite can pick it up
+    destroyed = sprite_manager.addDestroyListener([this](SpriteId id) {
+        removeCollider(id);
+    });
+}
+
+CollisionWorld::~CollisionWorld()
+{
+    sprite_manager.removeChangeListener(changes);
+    sprite_manager.removeDestroyListener(destroyed);
+}
+
+CollisionWorld::Entry* CollisionWorld::findEntry(SpriteId id)
+{
+    const size_t slot = spriteSlot(id);
+    if (slot >= entries.size() || !entries[slot].active || entries[slot].id != id) {
+        return nullptr;
+    }
+    return &entries[slot];
+}
+
+const CollisionWorld::Entry* CollisionWorld::findEntry(SpriteId id) const
+{
+    return const_cast<CollisionWorld*>(this)->findEntry(id);
+}
+
+CollisionWorld::Entry& CollisionWorld::entryOf(SpriteId id)
+{
+    return entries[spriteSlot(id)];
+}
+
+void CollisionWorld::setCollider(SpriteId id, const Collider& collider)
+{
+    if (!sprite_manager.isAlive(id)) {
+        return;
+    }
+    const size_t slot = spriteSlot(id);
+    if (slot >= entries.size()) {
+        entries.resize(slot + 1);
+    }
+    Entry& entry = entries[slot];
+    if (!entry.active) {
+        entry.active = true;
+        entry.id = id;
+        collider_count++;
+    }
+    entry.collider = collider;
+    pending.mark(id);
+}
+
+void CollisionWorld::removeCollider(SpriteId id)
+{
+    Entry* entry = findEntry(id);
+    if (entry == nullptr) {
+        return;
+    }
+    for (SpriteId other : entry->touching) {
+        std::vector<SpriteId>& others = entryOf(other).touching;
+        others.erase(std::find(others.begin(), others.end(), id));
+        events.push_back(CollisionEvent { id, other, false });
+        contact_count--;
+    }
+    entry->touching.clear();
+    entry->active = false;
+    broadphase.remove(id);
+    collider_count--;
+}
+
+std::optional<Collider> CollisionWorld::getCollider(SpriteId id) const
+{
+    const Entry* entry = findEntry(id);
+    if (entry == nullptr) {
+        return std::nullopt;
+    }
+    return entry->collider;
+}
+
+float CollisionWorld::extentOf(const Collider& collider)
+{
+    if (collider.shape == ColliderShape::Circle) {
+        return collider.radius;
+    }
+    return std::max(collider.half_extents.x, collider.half_extents.y);
+}
+
+bool CollisionWorld::overlaps(const Entry& a, const Entry& b)
+{
+    const bool a_box = a.collider.shape == ColliderShape::Box;
+    const bool b_box = b.collider.shape == ColliderShape::Box;
+
+    if (a_box && b_box) {
+        const glm::vec2 distance = glm::abs(a.position - b.position);
+        const glm::vec2 reach = a.collider.half_extents + b.collider.half_extents;
+        return distance.x <= reach.x && distance.y <= reach.y;
+    }
+    if (!a_box && !b_box) {
+        const glm::vec2 offset = a.position - b.position;
+        const float reach = a.collider.radius + b.collider.radius;
+        return glm::dot(offset, offset) <= reach * reach;
+    }
+
+    // Circle against the closest point of the box
+    const Entry& box = a_box ? a : b;
+    const Entry& circle = a_box ? b : a;
+    const glm::vec2 closest = glm::clamp(
+        circle.position,
+        box.position - box.collider.half_extents,
+        box.position + box.collider.half_extents
+    );
+    const glm::vec2 offset = circle.position - closest;
+    return glm::dot(offset, offset) <= circle.collider.radius * circle.collider.radius;
+}
+
+void CollisionWorld::addContact(SpriteId a, SpriteId b)
+{
+    entryOf(a).touching.push_back(b);
+    entryOf(b).touching.push_back(a);
+    events.push_back(CollisionEvent { a, b, true });
+    contact_count++;
+}
+
+void CollisionWorld::removeContact(SpriteId a, SpriteId b)
+{
+    const auto erase = [](std::vector<SpriteId>& ids, SpriteId id) {
+        const auto found = std::find(ids.begin(), ids.end(), id);
+        *found = ids.back();
+        ids.pop_back();
+    };
+    erase(entryOf(a).touching, b);
+    erase(entryOf(b).touching, a);
+    events.push_back(CollisionEvent { a, b, false });
+    contact_count--;
+}
+
+// Everything that moved goes into the grid first so the queries after see where things are
+// now. Each moved collider then redoes its contacts, a pair of moved colliders is handled
+// by whichever of the two comes first.
+
+void CollisionWorld::step()
+{
+    sprite_manager.takeChanges(changes, moved);
+    for (SpriteId id : moved) {
+        if (findEntry(id) != nullptr) {
+            pending.mark(id);
+        }
+    }
+    pending.take(moved);
+
+    // Pending ids can have lost their collider since they were marked
+    std::erase_if(moved, [&](SpriteId id) {
+        return findEntry(id) == nullptr;
+    });
+
+    for (SpriteId id : moved) {
+        Entry& entry = entryOf(id);
+        entry.position = sprite_manager.getPosition(id);
+        broadphase.update(id, entry.position, extentOf(entry.collider));
+    }
+
+    for (SpriteId id : moved) {
+        Entry& entry = entryOf(id);
+        const float extent = extentOf(entry.collider);
+
+        candidates.clear();
+        broadphase.query(SpriteBounds { entry.position - extent, entry.position + extent }, candidates);
+
+        overlapping.clear();
+        for (SpriteId other : candidates) {
+            if (other != id && !entryOf(other).visited && overlaps(entry, entryOf(other))) {
+                overlapping.push_back(other);
+            }
+        }
+
+        // Contacts with visited colliders are already up to date, the rest either still
+        // touch or have ended
+        for (size_t i = 0; i < entry.touching.size();) {
+            const SpriteId other = entry.touching[i];
+            if (entryOf(other).visited || std::find(overlapping.begin(), overlapping.end(), other) != overlapping.end()) {
+                i++;
+            } else {
+                removeContact(id, other);
+            }
+        }
+        for (SpriteId other : overlapping) {
+            if (std::find(entry.touching.begin(), entry.touching.end(), other) == entry.touching.end()) {
+                addContact(id, other);
+            }
+        }
+
+        entry.visited = true;
+    }
+
+    for (SpriteId id : moved) {
+        entryOf(id).visited = false;
+    }
+}
+
+std::span<const CollisionEvent> CollisionWorld::getEvents() const
+{
+    return events;
+}
+
+void CollisionWorld::clearEvents()
+{
+    events.clear();
+}
+
+size_t CollisionWorld::getColliderCount() const
+{
+    return collider_count;
+}
+
+size_t CollisionWorld::getContactCount() const
+{
+    return contact_count;
+}
+
+} // namespace Engine
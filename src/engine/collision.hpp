@@ -0,0 +1,93 @@
+#pragma once
+
+#include "spatial_grid.hpp"
+#include "sprite.hpp"
+#include "../constructors.hpp"
+#include <cstdint>
+#include <optional>
+#include <span>
+#include <vector>
+#include <glm/glm.hpp>
+
+namespace Engine {
+
+enum class ColliderShape : uint8_t {
+    Box,
+    Circle,
+};
+
+// Centred on the sprite's position, boxes don't rotate
+struct Collider {
+    ColliderShape shape = ColliderShape::Box;
+    glm::vec2 half_extents = glm::vec2(50.f, 50.f);
+    float radius = 50.f;
+};
+
+struct CollisionEvent {
+    SpriteId a;
+    SpriteId b;
+    bool began;
+};
+
+// Tracks which sprites with colliders touch. Only colliders whose sprite moved, or that
+// were added or changed, are put back into the broadphase grid and tested again, pairs
+// where neither side moved keep whatever state they had. Events pile up until cleared so
+// they can be handed out once per frame. Has to go before the sprite manager does.
+
+class CollisionWorld {
+public:
+    constexpr static float DEFAULT_CELL_SIZE = 128.f;
+
+    explicit CollisionWorld(SpriteManager& sprite_manager, float cell_size = DEFAULT_CELL_SIZE);
+    ~CollisionWorld();
+    DELETE_COPY(CollisionWorld);
+    DELETE_MOVE(CollisionWorld);
+
+    void setCollider(SpriteId id, const Collider& collider);
+    // Ends every contact the sprite has, destroying the sprite does the same
+    void removeCollider(SpriteId id);
+    std::optional<Collider> getCollider(SpriteId id) const;
+
+    void step();
+
+    std::span<const CollisionEvent> getEvents() const;
+    void clearEvents();
+    size_t getColliderCount() const;
+    size_t getContactCount() const;
+
+private:
+    struct Entry {
+        SpriteId id = 0;
+        Collider collider;
+        glm::vec2 position = glm::vec2(0.f, 0.f);
+        bool active = false;
+        // Already retested this step, pairs with it were handled from its side
+        bool visited = false;
+        std::vector<SpriteId> touching;
+    };
+
+    // The sprite's entry if it has a collider, a stale id doesn't match whoever has its slot now
+    Entry* findEntry(SpriteId id);
+    const Entry* findEntry(SpriteId id) const;
+    Entry& entryOf(SpriteId id);
+    static bool overlaps(const Entry& a, const Entry& b);
+    static float extentOf(const Collider& collider);
+    void addContact(SpriteId a, SpriteId b);
+    void removeContact(SpriteId a, SpriteId b);
+
+    SpriteManager& sprite_manager;
+    SpriteManager::ChangeListener changes;
+    SpriteManager::DestroyListener destroyed;
+    SpatialGrid broadphase;
+    // Indexed by sprite slot
+    std::vector<Entry> entries;
+    DirtyIds pending;
+    std::vector<SpriteId> moved;
+    std::vector<SpriteId> candidates;
+    std::vector<SpriteId> overlapping;
+    std::vector<CollisionEvent> events;
+    size_t collider_count = 0;
+    size_t contact_count = 0;
+};
+
+} // namespace Engine
@@ -1,12 +1,26 @@
 #include <pch.hpp>
 
 #include "debug.hpp"
+#include "lua_profiler.hpp"
+#include "frame_stats.hpp"
+#include "../gfx/gpu_timer.hpp"
+#include "../gfx/gl_state.hpp"
+#include "../gfx/render_queue.hpp"
+#include "../platform.hpp"
 #include "imgui.h"
+#include <algorithm>
 
 namespace Engine {
 
+DebugContext::DebugContext(LuaProfiler& lua_profiler, const GpuTimer& gpu_timer, FrameStats& frame_stats, const RenderQueue& render_queue)
+    : lua_profiler(lua_profiler), gpu_timer(gpu_timer), frame_stats(frame_stats), render_queue(render_queue)
+{
+
+}
+
 void DebugContext::tryRender(float delta_time)
 {
+    recordTiming(delta_time);
     if (enabled) {
         render(delta_time);
     }
@@ -24,18 +38,253 @@ void DebugContext::render(float delta_time)
     if (wireframe) {
         if (ImGui::Button("Disable Wireframe")) {
             wireframe = false;
-            glPolygonMode(GL_FRONT_AND_BACK, GL_FILL);
+            GL_STATE.setPolygonMode(GL_FILL);
         }
     } else {
         if (ImGui::Button("Enable Wireframe")) {
             wireframe = true;
-            glPolygonMode(GL_FRONT_AND_BACK, GL_LINE);
+            GL_STATE.setPolygonMode(GL_LINE);
         }
     }
 
-    ImGui::Text("FPS: %.1f", 1.f / delta_time);
+    renderFrameStats();
+    renderGpuTiming();
+    renderDrawStats();
+    renderFrameProfiler();
+    renderLuaProfiler();
 
     ImGui::End();
 }
 
+void DebugContext::renderFrameStats()
+{
+    const FrameStats::Summary summary = frame_stats.getSummary();
+    ImGui::Text("FPS: %.1f (avg over %zu frames)", summary.average > 0.f ? 1000.f / summary.average : 0.f, summary.count);
+    ImGui::Text("min %.2f  avg %.2f  p95 %.2f  p99 %.2f  max %.2f ms",
+        summary.min, summary.average, summary.p95, summary.p99, summary.max);
+
+    if (!ImGui::CollapsingHeader("Frame Times")) {
+        return;
+    }
+
+    const auto history = frame_stats.getHistory();
+    const float scale_max = std::max(summary.max, 1.f);
+    ImGui::PlotLines("##frame_times", history.data(), static_cast<int>(history.size()), 0,
+        "Frame time (ms)", 0.f, scale_max, ImVec2(0, 80));
+
+    const auto histogram = frame_stats.getHistogram(HISTOGRAM_BINS, scale_max);
+    const float bin_max = histogram.empty() ? 1.f : *std::max_element(histogram.begin(), histogram.end());
+    const std::string histogram_label = std::format("0 - {:.1f} ms", scale_max);
+    ImGui::PlotHistogram("##frame_histogram", histogram.data(), static_cast<int>(histogram.size()), 0,
+        histogram_label.c_str(), 0.f, bin_max, ImVec2(0, 80));
+
+    float threshold = frame_stats.getHitchThreshold();
+    if (ImGui::SliderFloat("Hitch threshold (ms)", &threshold, 1.f, 200.f, "%.1f")) {
+        frame_stats.setHitchThreshold(threshold);
+    }
+    ImGui::Text("Hitches: %zu", frame_stats.getHitchCount());
+    if (ImGui::Button("Export CSV")) {
+        frame_stats.exportCsv(getExecutablePath() / "frame_times.csv");
+    }
+}
+
+// History is recorded every frame, even with the window closed, so the graphs are already
+// filled in when it's opened
+
+void DebugContext::recordTiming(float delta_time)
+{
+    const auto& gpu_frame = gpu_timer.getLatest();
+    cpu_history[history_offset] = delta_time * 1000.f;
+    gpu_history[history_offset] = gpu_frame ? gpu_frame->total_milliseconds : 0.f;
+    history_offset = (history_offset + 1) % TIMING_HISTORY;
+
+    const uint64_t avoided = GL_STATE.getAvoidedCount();
+    gl_avoided_frame = avoided - gl_avoided_total;
+    gl_avoided_total = avoided;
+}
+
+void DebugContext::renderGpuTiming()
+{
+    if (!ImGui::CollapsingHeader("CPU / GPU Timing", ImGuiTreeNodeFlags_DefaultOpen)) {
+        return;
+    }
+
+    const float cpu_max = *std::max_element(cpu_history.begin(), cpu_history.end());
+    const float gpu_max = *std::max_element(gpu_history.begin(), gpu_history.end());
+    const float scale_max = std::max({ cpu_max, gpu_max, 1.f });
+
+    const size_t latest = (history_offset + TIMING_HISTORY - 1) % TIMING_HISTORY;
+    const std::string cpu_label = std::format("{:.2f} ms", cpu_history[latest]);
+    ImGui::PlotLines("CPU frame", cpu_history.data(), static_cast<int>(TIMING_HISTORY), static_cast<int>(history_offset),
+        cpu_label.c_str(), 0.f, scale_max, ImVec2(0, 60));
+
+    if (!gpu_timer.isSupported()) {
+        ImGui::Text("GPU timing unavailable on %s", gpu_timer.getRendererName().c_str());
+        return;
+    }
+
+    const std::string gpu_label = std::format("{:.2f} ms", gpu_history[latest]);
+    ImGui::PlotLines("GPU frame", gpu_history.data(), static_cast<int>(TIMING_HISTORY), static_cast<int>(history_offset),
+        gpu_label.c_str(), 0.f, scale_max, ImVec2(0, 60));
+    if (gpu_timer.isSoftware()) {
+        ImGui::TextUnformatted("Software renderer, GPU times are CPU rasterization");
+    }
+
+    const auto& gpu_frame = gpu_timer.getLatest();
+    if (!gpu_frame) {
+        return;
+    }
+    for (size_t i = 0; i < gpu_frame->section_count; i++) {
+        ImGui::Text("%s: %.3f ms", gpu_frame->sections[i].name, gpu_frame->sections[i].milliseconds);
+    }
+    ImGui::Text("Skipped readbacks: %zu", gpu_timer.getSkippedCount());
+}
+
+// The debug window is built before this frame's draws are flushed, so these are the
+// previous frame's numbers
+
+void DebugContext::renderDrawStats()
+{
+    if (!ImGui::CollapsingHeader("Draw Calls", ImGuiTreeNodeFlags_DefaultOpen)) {
+        return;
+    }
+
+    const RenderQueue::Stats& stats = render_queue.getStats();
+    ImGui::Text("Draw calls: %zu", stats.draw_calls);
+    ImGui::Text("State changes: %zu (%zu elided)", stats.getStateChanges(), stats.elided_binds);
+    ImGui::Text("Programs: %zu  Textures: %zu  Vertex arrays: %zu",
+        stats.program_binds, stats.texture_binds, stats.vertex_array_binds);
+    ImGui::Text("GL calls avoided: %llu last frame, %llu total (%llu issued)",
+        static_cast<unsigned long long>(gl_avoided_frame),
+        static_cast<unsigned long long>(gl_avoided_total),
+        static_cast<unsigned long long>(GL_STATE.getIssuedCount()));
+}
+
+void DebugContext::renderFrameProfiler()
+{
+    if (!ImGui::CollapsingHeader("Frame Profiler")) {
+        return;
+    }
+
+    bool profiler_enabled = GLOBAL_PROFILER.isEnabled();
+    if (ImGui::Checkbox("Enabled", &profiler_enabled)) {
+        GLOBAL_PROFILER.setEnabled(profiler_enabled);
+    }
+    ImGui::SameLine();
+    bool paused = paused_frame.has_value();
+    if (ImGui::Checkbox("Pause", &paused)) {
+        paused_frame = paused ? GLOBAL_PROFILER.getLastFrame() : std::nullopt;
+    }
+    ImGui::SameLine();
+    if (ImGui::Button("Export Chrome Trace")) {
+        GLOBAL_PROFILER.exportChromeTrace(getExecutablePath() / "trace.json");
+    }
+
+    const std::optional<ProfileFrame> frame = paused_frame ? paused_frame : GLOBAL_PROFILER.getLastFrame();
+    if (!frame) {
+        ImGui::TextUnformatted("No frames recorded");
+        return;
+    }
+
+    const float frame_ms = (frame->end - frame->start) / 1e6f;
+    ImGui::Text("Frame %llu: %.2f ms, %zu zones, %zu dropped",
+        static_cast<unsigned long long>(frame->index), frame_ms, frame->zones.size(), GLOBAL_PROFILER.getDroppedCount());
+
+    const auto totals = summarizeFrame(*frame);
+    const auto thread_names = GLOBAL_PROFILER.getThreadNames();
+    if (ImGui::BeginTable("frame_zones", 4, ImGuiTableFlags_Borders | ImGuiTableFlags_RowBg)) {
+        ImGui::TableSetupColumn("Zone");
+        ImGui::TableSetupColumn("Calls");
+        ImGui::TableSetupColumn("Total ms");
+        ImGui::TableSetupColumn("Frame %");
+        ImGui::TableHeadersRow();
+        uint32_t current_thread = UINT32_MAX;
+        for (const auto& total : totals) {
+            if (total.thread != current_thread) {
+                current_thread = total.thread;
+                ImGui::TableNextRow();
+                ImGui::TableNextColumn();
+                ImGui::TextUnformatted(total.thread < thread_names.size() ? thread_names[total.thread].c_str() : "?");
+            }
+            ImGui::TableNextRow();
+            ImGui::TableNextColumn();
+            ImGui::Text("%*s%s", static_cast<int>(total.depth + 1) * 2, "", total.name);
+            ImGui::TableNextColumn();
+            ImGui::Text("%zu", total.calls);
+            ImGui::TableNextColumn();
+            ImGui::Text("%.3f", total.duration / 1e6f);
+            ImGui::TableNextColumn();
+            ImGui::Text("%.1f", frame_ms > 0.f ? 100.f * (total.duration / 1e6f) / frame_ms : 0.f);
+        }
+        ImGui::EndTable();
+    }
+}
+
+// Runs on the render thread, the profiler only hands out copies of its data so this never
+// holds its lock while drawing
+
+void DebugContext::renderLuaProfiler()
+{
+    if (!ImGui::CollapsingHeader("Lua Profiler")) {
+        return;
+    }
+
+    if (lua_profiler.isRunning()) {
+        if (ImGui::Button("Stop")) {
+            lua_profiler.stop();
+        }
+    } else {
+        if (ImGui::Button("Start")) {
+            lua_profiler.start();
+        }
+    }
+    ImGui::SameLine();
+    if (ImGui::Button("Reset")) {
+        lua_profiler.reset();
+    }
+    ImGui::SameLine();
+    if (ImGui::Button("Export Folded Stacks")) {
+        lua_profiler.exportFoldedStacks(getExecutablePath() / "lua_profile.folded");
+    }
+
+    const size_t sample_count = lua_profiler.getSampleCount();
+    ImGui::Text("Samples: %zu", sample_count);
+    if (sample_count == 0) {
+        return;
+    }
+
+    const auto functions = lua_profiler.getFunctionStats();
+    if (ImGui::BeginTable("lua_functions", 3, ImGuiTableFlags_Borders | ImGuiTableFlags_RowBg)) {
+        ImGui::TableSetupColumn("Function");
+        ImGui::TableSetupColumn("Self %");
+        ImGui::TableSetupColumn("Total %");
+        ImGui::TableHeadersRow();
+        for (size_t i = 0; i < functions.size() && i < PROFILER_ROWS; i++) {
+            ImGui::TableNextRow();
+            ImGui::TableNextColumn();
+            ImGui::TextUnformatted(functions[i].name.c_str());
+            ImGui::TableNextColumn();
+            ImGui::Text("%.1f", 100.f * functions[i].self_samples / sample_count);
+            ImGui::TableNextColumn();
+            ImGui::Text("%.1f", 100.f * functions[i].total_samples / sample_count);
+        }
+        ImGui::EndTable();
+    }
+
+    const auto lines = lua_profiler.getLineStats();
+    if (ImGui::BeginTable("lua_lines", 2, ImGuiTableFlags_Borders | ImGuiTableFlags_RowBg)) {
+        ImGui::TableSetupColumn("Line");
+        ImGui::TableSetupColumn("Samples %");
+        ImGui::TableHeadersRow();
+        for (size_t i = 0; i < lines.size() && i < PROFILER_ROWS; i++) {
+            ImGui::TableNextRow();
+            ImGui::TableNextColumn();
+            ImGui::TextUnformatted(lines[i].first.c_str());
+            ImGui::TableNextColumn();
+            ImGui::Text("%.1f", 100.f * lines[i].second / sample_count);
+        }
+        ImGui::EndTable();
+    }
+}
+
 } // namespace Engine
@@ -1,15 +1,54 @@
 #pragma once
 
+#include "profiler.hpp"
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <cstddef>
+#include <optional>
+
 namespace Engine {
 
+class LuaProfiler;
+class GpuTimer;
+class FrameStats;
+class RenderQueue;
+
 class DebugContext {
 public:
+    constexpr static size_t PROFILER_ROWS = 15;
+    constexpr static size_t TIMING_HISTORY = 240;
+    constexpr static size_t HISTOGRAM_BINS = 40;
+
+    DebugContext(LuaProfiler& lua_profiler, const GpuTimer& gpu_timer, FrameStats& frame_stats, const RenderQueue& render_queue);
+
     void tryRender(float delta_time);
     void toggle();
 private:
     void render(float delta_time);
-    bool enabled = false;
+    void renderLuaProfiler();
+    void renderFrameProfiler();
+    void renderFrameStats();
+    void renderGpuTiming();
+    void renderDrawStats();
+    void recordTiming(float delta_time);
+
+    LuaProfiler& lua_profiler;
+    const GpuTimer& gpu_timer;
+    FrameStats& frame_stats;
+    const RenderQueue& render_queue;
+    // Toggled from the simulation thread, read from the render thread
+    std::atomic<bool> enabled = false;
     bool wireframe = false;
+    // Frame shown while the breakdown is paused
+    std::optional<ProfileFrame> paused_frame;
+    // Milliseconds per frame, oldest at history_offset
+    std::array<float, TIMING_HISTORY> cpu_history {};
+    std::array<float, TIMING_HISTORY> gpu_history {};
+    size_t history_offset = 0;
+    // GL calls the state cache dropped, running total at the last frame and the difference
+    uint64_t gl_avoided_total = 0;
+    uint64_t gl_avoided_frame = 0;
 };
 
 } // namespace Engine
@@ -0,0 +1,105 @@
+#include <pch.hpp>
+
+#include "ecs.hpp"
+#include <atomic>
+
+namespace Engine {
+
+ComponentId nextComponentId()
+{
+    static std::atomic<ComponentId> next = 0;
+    return next++;
+}
+
+bool ComponentPoolBase::contains(Entity entity) const
+{
+    const uint32_t index = entityIndex(entity);
+    return index < sparse.size() && sparse[index] != NOT_PRESENT && dense[sparse[index]] == entity;
+}
+
+size_t ComponentPoolBase::size() const
+{
+    return dense.size();
+}
+
+std::span<const Entity> ComponentPoolBase::getEntities() const
+{
+    return dense;
+}
+
+size_t ComponentPoolBase::insertEntity(Entity entity)
+{
+    const uint32_t index = entityIndex(entity);
+    if (index >= sparse.size()) {
+        sparse.resize(index + 1, NOT_PRESENT);
+    }
+    sparse[index] = static_cast<uint32_t>(dense.size());
+    dense.push_back(entity);
+    return dense.size() - 1;
+}
+
+size_t ComponentPoolBase::eraseEntity(Entity entity)
+{
+    const size_t position = denseIndex(entity);
+    const Entity moved = dense.back();
+    dense[position] = moved;
+    sparse[entityIndex(moved)] = static_cast<uint32_t>(position);
+    sparse[entityIndex(entity)] = NOT_PRESENT;
+    dense.pop_back();
+    return position;
+}
+
+size_t ComponentPoolBase::denseIndex(Entity entity) const
+{
+    return sparse[entityIndex(entity)];
+}
+
+// Slots are reused most recently freed first, the generation keeps stale handles out
+
+Entity EntityRegistry::create()
+{
+    uint32_t index;
+    if (!free_slots.empty()) {
+        index = free_slots.back();
+        free_slots.pop_back();
+    } else {
+        index = static_cast<uint32_t>(generations.size());
+        generations.push_back(0);
+    }
+    alive++;
+    return (static_cast<Entity>(generations[index]) << 32) | index;
+}
+
+void EntityRegistry::destroy(Entity entity)
+{
+    if (!isAlive(entity)) {
+        return;
+    }
+    for (const auto& pool : pools) {
+        if (pool) {
+            pool->remove(entity);
+        }
+    }
+    const uint32_t index = entityIndex(entity);
+    generations[index] = (generations[index] + 1) & ((uint32_t(1) << ENTITY_GENERATION_BITS) - 1);
+    free_slots.push_back(index);
+    alive--;
+}
+
+bool EntityRegistry::isAlive(Entity entity) const
+{
+    const uint32_t index = entityIndex(entity);
+    return index < generations.size() && generations[index] == entityGeneration(entity);
+}
+
+size_t EntityRegistry::size() const
+{
+    return alive;
+}
+
+ComponentPoolBase* EntityRegistry::findPool(ComponentId id)
+{
+    return id < pools.size() ? pools[id].get() : nullptr;
+}
+
+} // namespace Engine
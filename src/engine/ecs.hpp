@@ -0,0 +1,369 @@
+#pragma once
+
+#include "../constructors.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <memory>
+#include <span>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+namespace Engine {
+
+// Slot index in the low half, generation in the bits above. Destroying an entity bumps the
+// generation of its slot so old handles stop matching once the slot is reused. Scripts get
+// entities as Lua numbers, so the generation wraps early enough for every entity to stay
+// exact as a double, same as sprite ids.
+using Entity = uint64_t;
+using ComponentId = size_t;
+
+constexpr size_t ENTITY_GENERATION_BITS = 20;
+
+// Its generation is wider than any entity can have, and it is still exact as a double
+constexpr Entity NULL_ENTITY = (Entity(1) << (32 + ENTITY_GENERATION_BITS + 1)) - 1;
+
+constexpr uint32_t entityIndex(Entity entity)
+{
+    return static_cast<uint32_t>(entity);
+}
+
+constexpr uint32_t entityGeneration(Entity entity)
+{
+    return static_cast<uint32_t>(entity >> 32);
+}
+
+// Ids are handed out process wide so C++ types and script defined components never clash
+ComponentId nextComponentId();
+
+template <typename T>
+ComponentId componentId()
+{
+    static const ComponentId id = nextComponentId();
+    return id;
+}
+
+// Sparse set, the sparse array maps an entity's slot to its position in the dense arrays.
+// Entities and their components are packed at the front with no holes, removing one
+// moves the last into its place.
+
+class ComponentPoolBase {
+public:
+    ComponentPoolBase() = default;
+    virtual ~ComponentPoolBase() = default;
+    DELETE_COPY(ComponentPoolBase);
+    DELETE_MOVE(ComponentPoolBase);
+
+    virtual void remove(Entity entity) = 0;
+    // Drops every component without running any hooks
+    virtual void clear() = 0;
+
+    bool contains(Entity entity) const;
+    size_t size() const;
+    std::span<const Entity> getEntities() const;
+
+protected:
+    constexpr static uint32_t NOT_PRESENT = std::numeric_limits<uint32_t>::max();
+
+    // Returns the dense position the entity was given
+    size_t insertEntity(Entity entity);
+    // Returns the dense position the entity had, the last entity now lives there
+    size_t eraseEntity(Entity entity);
+    size_t denseIndex(Entity entity) const;
+
+    std::vector<uint32_t> sparse;
+    std::vector<Entity> dense;
+};
+
+template <typename T>
+class ComponentPool : public ComponentPoolBase {
+public:
+    using RemoveHook = std::function<void(Entity, T&)>;
+
+    // Replaces the component if the entity already has one, the old one goes through the
+    // remove hook first
+    template <typename... Args>
+    T& emplace(Entity entity, Args&&... args);
+    void remove(Entity entity) override;
+    void clear() override;
+
+    T& get(Entity entity);
+    const T& get(Entity entity) const;
+    T* tryGet(Entity entity);
+
+    // Same order as getEntities
+    std::span<T> getComponents();
+    std::span<const T> getComponents() const;
+
+    // Runs before a component is removed, including when its entity is destroyed
+    void setRemoveHook(RemoveHook hook);
+
+private:
+    std::vector<T> components;
+    RemoveHook remove_hook;
+};
+
+template <typename... Ts>
+class View;
+
+class EntityRegistry {
+public:
+    EntityRegistry() = default;
+    DELETE_COPY(EntityRegistry);
+    DEFAULT_MOVE(EntityRegistry);
+
+    Entity create();
+    // Removes every component first, the remove hooks see the entity still alive
+    void destroy(Entity entity);
+    bool isAlive(Entity entity) const;
+    size_t size() const;
+
+    template <typename T, typename... Args>
+    T& emplace(Entity entity, Args&&... args);
+    template <typename T>
+    void remove(Entity entity);
+    template <typename T>
+    bool has(Entity entity) const;
+    template <typename T>
+    T& get(Entity entity);
+    template <typename T>
+    T* tryGet(Entity entity);
+
+    // One pool per C++ type, created on first use
+    template <typename T>
+    ComponentPool<T>& getPool();
+
+    // Pools that aren't tied to a type, for components defined at runtime. All of them can
+    // share a storage type and still be told apart by id.
+    template <typename T>
+    ComponentId createPool();
+    template <typename T>
+    ComponentPool<T>& getPool(ComponentId id);
+    ComponentPoolBase* findPool(ComponentId id);
+
+    template <typename... Ts>
+    View<Ts...> view();
+
+private:
+    template <typename T>
+    ComponentPool<T>& poolAt(ComponentId id);
+
+    std::vector<std::unique_ptr<ComponentPoolBase>> pools;
+    std::vector<uint32_t> generations;
+    std::vector<uint32_t> free_slots;
+    size_t alive = 0;
+};
+
+// Visits every entity that has all of the components. Walks the smallest pool and looks
+// the rest up, so the cost follows the rarest component rather than the most common one.
+
+template <typename... Ts>
+class View {
+public:
+    explicit View(ComponentPool<Ts>&... pools);
+
+    // Called as fn(entity, components...), adding or removing these components on other
+    // entities while iterating isn't allowed
+    template <typename Fn>
+    void each(Fn&& fn);
+
+private:
+    const ComponentPoolBase& smallest() const;
+
+    std::tuple<ComponentPool<Ts>*...> pools;
+};
+
+template <typename T>
+template <typename... Args>
+T& ComponentPool<T>::emplace(Entity entity, Args&&... args)
+{
+    if (contains(entity)) {
+        T& component = components[denseIndex(entity)];
+        if (remove_hook) {
+            remove_hook(entity, component);
+        }
+        component = T(std::forward<Args>(args)...);
+        return component;
+    }
+    insertEntity(entity);
+    return components.emplace_back(std::forward<Args>(args)...);
+}
+
+template <typename T>
+void ComponentPool<T>::remove(Entity entity)
+{
+    if (!contains(entity)) {
+        return;
+    }
+    if (remove_hook) {
+        remove_hook(entity, components[denseIndex(entity)]);
+    }
+    const size_t index = eraseEntity(entity);
+    if (index != components.size() - 1) {
+        components[index] = std::move(components.back());
+    }
+    components.pop_back();
+}
+
+template <typename T>
+void ComponentPool<T>::clear()
+{
+    for (const Entity entity : dense) {
+        sparse[entityIndex(entity)] = NOT_PRESENT;
+    }
+    dense.clear();
+    components.clear();
+}
+
+template <typename T>
+T& ComponentPool<T>::get(Entity entity)
+{
+    return components[denseIndex(entity)];
+}
+
+template <typename T>
+const T& ComponentPool<T>::get(Entity entity) const
+{
+    return components[denseIndex(entity)];
+}
+
+template <typename T>
+T* ComponentPool<T>::tryGet(Entity entity)
+{
+    return contains(entity) ? &components[denseIndex(entity)] : nullptr;
+}
+
+template <typename T>
+std::span<T> ComponentPool<T>::getComponents()
+{
+    return components;
+}
+
+template <typename T>
+std::span<const T> ComponentPool<T>::getComponents() const
+{
+    return components;
+}
+
+template <typename T>
+void ComponentPool<T>::setRemoveHook(RemoveHook hook)
+{
+    remove_hook = std::move(hook);
+}
+
+template <typename T, typename... Args>
+T& EntityRegistry::emplace(Entity entity, Args&&... args)
+{
+    return getPool<T>().emplace(entity, std::forward<Args>(args)...);
+}
+
+template <typename T>
+void EntityRegistry::remove(Entity entity)
+{
+    getPool<T>().remove(entity);
+}
+
+template <typename T>
+bool EntityRegistry::has(Entity entity) const
+{
+    const ComponentId id = componentId<T>();
+    return id < pools.size() && pools[id] && pools[id]->contains(entity);
+}
+
+template <typename T>
+T& EntityRegistry::get(Entity entity)
+{
+    return getPool<T>().get(entity);
+}
+
+template <typename T>
+T* EntityRegistry::tryGet(Entity entity)
+{
+    return getPool<T>().tryGet(entity);
+}
+
+template <typename T>
+ComponentPool<T>& EntityRegistry::getPool()
+{
+    return poolAt<T>(componentId<T>());
+}
+
+template <typename T>
+ComponentId EntityRegistry::createPool()
+{
+    const ComponentId id = nextComponentId();
+    poolAt<T>(id);
+    return id;
+}
+
+template <typename T>
+ComponentPool<T>& EntityRegistry::getPool(ComponentId id)
+{
+    return poolAt<T>(id);
+}
+
+template <typename T>
+ComponentPool<T>& EntityRegistry::poolAt(ComponentId id)
+{
+    if (id >= pools.size()) {
+        pools.resize(id + 1);
+    }
+    if (!pools[id]) {
+        pools[id] = std::make_unique<ComponentPool<T>>();
+    }
+    return static_cast<ComponentPool<T>&>(*pools[id]);
+}
+
+template <typename... Ts>
+View<Ts...> EntityRegistry::view()
+{
+    return View<Ts...>(getPool<Ts>()...);
+}
+
+template <typename... Ts>
+View<Ts...>::View(ComponentPool<Ts>&... pools)
+    : pools(&pools...)
+{
+
+}
+
+template <typename... Ts>
+const ComponentPoolBase& View<Ts...>::smallest() const
+{
+    const ComponentPoolBase* result = std::get<0>(pools);
+    std::apply([&](const auto*... pool) {
+        ((result = pool->size() < result->size() ? pool : result), ...);
+    }, pools);
+    return *result;
+}
+
+template <typename... Ts>
+template <typename Fn>
+void View<Ts...>::each(Fn&& fn)
+{
+    // A single pool is already the exact set, no lookups needed
+    if constexpr (sizeof...(Ts) == 1) {
+        auto& pool = *std::get<0>(pools);
+        const std::span<const Entity> entities = pool.getEntities();
+        const auto components = pool.getComponents();
+        for (size_t i = 0; i < entities.size(); i++) {
+            fn(entities[i], components[i]);
+        }
+    } else {
+        const ComponentPoolBase& lead = smallest();
+        for (const Entity entity : lead.getEntities()) {
+            const bool matches = std::apply([&](const auto*... pool) {
+                return (pool->contains(entity) && ...);
+            }, pools);
+            if (matches) {
+                std::apply([&](auto*... pool) {
+                    fn(entity, pool->get(entity)...);
+                }, pools);
+            }
+        }
+    }
+}
+
+} // namespace Engine
@@ -0,0 +1,244 @@
+#include <pch.hpp>
+
+#include "float_buffer.hpp"
+#include "simd.hpp"
+#include <algorithm>
+#include <stdexcept>
+
+namespace Engine {
+
+// Each op is an SSE2 loop over 4 floats at a time with a scalar tail, or just the
+// scalar loop where SSE2 isn't available
+
+#if defined(GAME_SIMD_SSE2)
+#define FLOAT_BUFFER_VECTOR_OP(intrinsic) [](__m128 lhs, __m128 rhs) { return intrinsic(lhs, rhs); }
+#else
+#define FLOAT_BUFFER_VECTOR_OP(intrinsic) nullptr
+#endif
+
+template <typename VectorOp, typename ScalarOp>
+void transform(float* dst, const float* src, size_t count, VectorOp vector_op, ScalarOp scalar_op)
+{
+    size_t i = 0;
+#if defined(GAME_SIMD_SSE2)
+    for (; i + 4 <= count; i += 4) {
+        _mm_storeu_ps(&dst[i], vector_op(_mm_loadu_ps(&dst[i]), _mm_loadu_ps(&src[i])));
+    }
+#endif
+    for (; i < count; i++) {
+        dst[i] = scalar_op(dst[i], src[i]);
+    }
+}
+
+FloatBuffer::FloatBuffer(size_t size)
+    : storage(std::make_shared<std::vector<float>>(size, 0.f)), length(size)
+{
+
+}
+
+FloatBuffer::FloatBuffer(std::vector<float> values)
+    : storage(std::make_shared<std::vector<float>>(std::move(values)))
+{
+    length = storage->size();
+}
+
+FloatBuffer::FloatBuffer(std::shared_ptr<std::vector<float>> storage, size_t offset, size_t length)
+    : storage(std::move(storage)), offset(offset), length(length)
+{
+
+}
+
+size_t FloatBuffer::size() const
+{
+    return length;
+}
+
+float FloatBuffer::get(size_t index) const
+{
+    if (index >= length) {
+        throw std::out_of_range(std::format("FloatBuffer index {} out of range for size {}", index, length));
+    }
+    return (*storage)[offset + index];
+}
+
+void FloatBuffer::set(size_t index, float value)
+{
+    if (index >= length) {
+        throw std::out_of_range(std::format("FloatBuffer index {} out of range for size {}", index, length));
+    }
+    (*storage)[offset + index] = value;
+}
+
+FloatBuffer FloatBuffer::slice(size_t begin, size_t end) const
+{
+    end = std::min(end, length);
+    begin = std::min(begin, end);
+    return FloatBuffer(storage, offset + begin, end - begin);
+}
+
+FloatBuffer FloatBuffer::clone() const
+{
+    const auto values = span();
+    return FloatBuffer(std::vector<float>(values.begin(), values.end()));
+}
+
+std::span<float> FloatBuffer::span()
+{
+    return std::span<float>(storage->data() + offset, length);
+}
+
+std::span<const float> FloatBuffer::span() const
+{
+    return std::span<const float>(storage->data() + offset, length);
+}
+
+void FloatBuffer::checkSameSize(const FloatBuffer& other) const
+{
+    if (other.size() != length) {
+        throw std::invalid_argument(std::format("FloatBuffer size mismatch, {} and {}", length, other.size()));
+    }
+}
+
+void FloatBuffer::fill(float value)
+{
+    const auto values = span();
+    std::fill(values.begin(), values.end(), value);
+}
+
+void FloatBuffer::add(const FloatBuffer& other)
+{
+    checkSameSize(other);
+    transform(span().data(), other.span().data(), length,
+        FLOAT_BUFFER_VECTOR_OP(_mm_add_ps),
+        [](float lhs, float rhs) { return lhs + rhs; }
+    );
+}
+
+void FloatBuffer::subtract(const FloatBuffer& other)
+{
+    checkSameSize(other);
+    transform(span().data(), other.span().data(), length,
+        FLOAT_BUFFER_VECTOR_OP(_mm_sub_ps),
+        [](float lhs, float rhs) { return lhs - rhs; }
+    );
+}
+
+void FloatBuffer::multiply(const FloatBuffer& other)
+{
+    checkSameSize(other);
+    transform(span().data(), other.span().data(), length,
+        FLOAT_BUFFER_VECTOR_OP(_mm_mul_ps),
+        [](float lhs, float rhs) { return lhs * rhs; }
+    );
+}
+
+void FloatBuffer::addScaled(const FloatBuffer& other, float factor)
+{
+    checkSameSize(other);
+#if defined(GAME_SIMD_SSE2)
+    const __m128 factor4 = _mm_set1_ps(factor);
+    transform(span().data(), other.span().data(), length,
+        [factor4](__m128 lhs, __m128 rhs) { return _mm_add_ps(lhs, _mm_mul_ps(rhs, factor4)); },
+        [factor](float lhs, float rhs) { return lhs + rhs * factor; }
+    );
+#else
+    transform(span().data(), other.span().data(), length, nullptr, [factor](float lhs, float rhs) { return lhs + rhs * factor; });
+#endif
+}
+
+void FloatBuffer::scale(float factor)
+{
+    float* data = span().data();
+    size_t i = 0;
+#if defined(GAME_SIMD_SSE2)
+    const __m128 factor4 = _mm_set1_ps(factor);
+    for (; i + 4 <= length; i += 4) {
+        _mm_storeu_ps(&data[i], _mm_mul_ps(_mm_loadu_ps(&data[i]), factor4));
+    }
+#endif
+    for (; i < length; i++) {
+        data[i] *= factor;
+    }
+}
+
+float FloatBuffer::sum() const
+{
+    const float* data = span().data();
+    float total = 0.f;
+    size_t i = 0;
+#if defined(GAME_SIMD_SSE2)
+    __m128 total4 = _mm_setzero_ps();
+    for (; i + 4 <= length; i += 4) {
+        total4 = _mm_add_ps(total4, _mm_loadu_ps(&data[i]));
+    }
+    total = horizontalSum(total4);
+#endif
+    for (; i < length; i++) {
+        total += data[i];
+    }
+    return total;
+}
+
+float FloatBuffer::dot(const FloatBuffer& other) const
+{
+    checkSameSize(other);
+    const float* lhs = span().data();
+    const float* rhs = other.span().data();
+    float total = 0.f;
+    size_t i = 0;
+#if defined(GAME_SIMD_SSE2)
+    __m128 total4 = _mm_setzero_ps();
+    for (; i + 4 <= length; i += 4) {
+        total4 = _mm_add_ps(total4, _mm_mul_ps(_mm_loadu_ps(&lhs[i]), _mm_loadu_ps(&rhs[i])));
+    }
+    total = horizontalSum(total4);
+#endif
+    for (; i < length; i++) {
+        total += lhs[i] * rhs[i];
+    }
+    return total;
+}
+
+float FloatBuffer::min() const
+{
+    if (length == 0) {
+        return 0.f;
+    }
+    const float* data = span().data();
+    float result = data[0];
+    size_t i = 0;
+#if defined(GAME_SIMD_SSE2)
+    __m128 result4 = _mm_set1_ps(result);
+    for (; i + 4 <= length; i += 4) {
+        result4 = _mm_min_ps(result4, _mm_loadu_ps(&data[i]));
+    }
+    result = horizontalMin(result4);
+#endif
+    for (; i < length; i++) {
+        result = std::min(result, data[i]);
+    }
+    return result;
+}
+
+float FloatBuffer::max() const
+{
+    if (length == 0) {
+        return 0.f;
+    }
+    const float* data = span().data();
+    float result = data[0];
+    size_t i = 0;
+#if defined(GAME_SIMD_SSE2)
+    __m128 result4 = _mm_set1_ps(result);
+    for (; i + 4 <= length; i += 4) {
+        result4 = _mm_max_ps(result4, _mm_loadu_ps(&data[i]));
+    }
+    result = horizontalMax(result4);
+#endif
+    for (; i < length; i++) {
+        result = std::max(result, data[i]);
+    }
+    return result;
+}
+
+} // namespace Engine
@@ -0,0 +1,54 @@
+#pragma once
+
+#include "../constructors.hpp"
+#include <cstddef>
+#include <memory>
+#include <span>
+#include <vector>
+
+namespace Engine {
+
+// Contiguous array of floats that scripts can hand to engine APIs without converting
+// through a Lua table. Copies and slices are views onto the same storage, use clone
+// for an independent copy.
+
+class FloatBuffer {
+public:
+    explicit FloatBuffer(size_t size);
+    explicit FloatBuffer(std::vector<float> values);
+    DEFAULT_COPY(FloatBuffer);
+    DEFAULT_MOVE(FloatBuffer);
+
+    size_t size() const;
+    float get(size_t index) const;
+    void set(size_t index, float value);
+
+    FloatBuffer slice(size_t begin, size_t end) const;
+    FloatBuffer clone() const;
+
+    std::span<float> span();
+    std::span<const float> span() const;
+
+    // Element wise ops require both buffers to be the same size
+    void fill(float value);
+    void add(const FloatBuffer& other);
+    void subtract(const FloatBuffer& other);
+    void multiply(const FloatBuffer& other);
+    void addScaled(const FloatBuffer& other, float factor);
+    void scale(float factor);
+
+    float sum() const;
+    float dot(const FloatBuffer& other) const;
+    float min() const;
+    float max() const;
+
+private:
+    FloatBuffer(std::shared_ptr<std::vector<float>> storage, size_t offset, size_t length);
+    void checkSameSize(const FloatBuffer& other) const;
+
+    std::shared_ptr<std::vector<float>> storage;
+    size_t offset = 0;
+    size_t length = 0;
+};
+
+} // namespace Engine
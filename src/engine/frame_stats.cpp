@@ -0,0 +1,165 @@
+#include <pch.hpp>
+
+#include "frame_stats.hpp"
+#include "profiler.hpp"
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <numeric>
+
+namespace Engine {
+
+FrameStats::FrameStats(size_t capacity)
+    : capacity(std::max<size_t>(capacity, 1))
+{
+    frame_times.reserve(this->capacity);
+}
+
+void FrameStats::record(float delta_time)
+{
+    const float milliseconds = delta_time * 1000.f;
+    {
+        std::lock_guard lock(mutex);
+        if (frame_times.size() < capacity) {
+            frame_times.push_back(milliseconds);
+        } else {
+            frame_times[next] = milliseconds;
+        }
+        next = (next + 1) % capacity;
+        recorded++;
+    }
+
+    // The first frame includes all the startup work, not worth reporting
+    if (recorded > 1 && milliseconds > hitch_threshold.load(std::memory_order_relaxed)) {
+        hitch_count.fetch_add(1, std::memory_order_relaxed);
+        logHitch(milliseconds);
+    }
+}
+
+// delta_time is measured at the top of the loop so it covers the frame the profiler
+// closed last, which is the one whose zones get logged
+
+void FrameStats::logHitch(float milliseconds) const
+{
+    const auto frame = GLOBAL_PROFILER.getLastFrame();
+    if (!frame || !GLOBAL_PROFILER.isEnabled()) {
+        Log::warn("Hitch: frame took {:.2f} ms, enable the profiler for a breakdown", milliseconds);
+        return;
+    }
+
+    Log::warn("Hitch: frame {} took {:.2f} ms", frame->index, milliseconds);
+    const auto thread_names = GLOBAL_PROFILER.getThreadNames();
+    for (const auto& total : summarizeFrame(*frame)) {
+        Log::warn("  [{}] {}{} {:.3f} ms ({} calls)",
+            total.thread < thread_names.size() ? thread_names[total.thread] : "?",
+            std::string(total.depth * 2, ' '),
+            total.name,
+            total.duration / 1e6f,
+            total.calls
+        );
+    }
+}
+
+void FrameStats::setHitchThreshold(float milliseconds)
+{
+    hitch_threshold.store(std::max(milliseconds, 0.f), std::memory_order_relaxed);
+}
+
+float FrameStats::getHitchThreshold() const
+{
+    return hitch_threshold.load(std::memory_order_relaxed);
+}
+
+size_t FrameStats::getHitchCount() const
+{
+    return hitch_count.load(std::memory_order_relaxed);
+}
+
+std::vector<float> FrameStats::getHistory() const
+{
+    std::lock_guard lock(mutex);
+    return orderedFrameTimes();
+}
+
+std::vector<float> FrameStats::orderedFrameTimes() const
+{
+    if (frame_times.size() < capacity) {
+        return frame_times;
+    }
+    std::vector<float> history;
+    history.reserve(capacity);
+    history.insert(history.end(), frame_times.begin() + next, frame_times.end());
+    history.insert(history.end(), frame_times.begin(), frame_times.begin() + next);
+    return history;
+}
+
+// Nearest rank percentiles, with only ~1000 samples interpolating doesn't buy anything
+
+FrameStats::Summary FrameStats::getSummary() const
+{
+    std::vector<float> sorted;
+    {
+        std::lock_guard lock(mutex);
+        sorted = frame_times;
+    }
+    if (sorted.empty()) {
+        return {};
+    }
+    std::sort(sorted.begin(), sorted.end());
+
+    auto percentile = [&](float fraction) {
+        const size_t rank = static_cast<size_t>(std::ceil(fraction * sorted.size()));
+        return sorted[std::clamp<size_t>(rank, 1, sorted.size()) - 1];
+    };
+
+    Summary summary;
+    summary.count = sorted.size();
+    summary.min = sorted.front();
+    summary.max = sorted.back();
+    summary.average = std::accumulate(sorted.begin(), sorted.end(), 0.f) / sorted.size();
+    summary.p50 = percentile(0.5f);
+    summary.p95 = percentile(0.95f);
+    summary.p99 = percentile(0.99f);
+    return summary;
+}
+
+std::vector<float> FrameStats::getHistogram(size_t bins, float max_milliseconds) const
+{
+    std::vector<float> histogram(bins, 0.f);
+    if (bins == 0 || max_milliseconds <= 0.f) {
+        return histogram;
+    }
+    std::lock_guard lock(mutex);
+    for (float milliseconds : frame_times) {
+        const size_t bin = static_cast<size_t>(milliseconds / max_milliseconds * bins);
+        histogram[std::min(bin, bins - 1)]++;
+    }
+    return histogram;
+}
+
+bool FrameStats::exportCsv(const std::filesystem::path& path) const
+{
+    std::ofstream file(path);
+    if (!file) {
+        Log::error("Failed to open {} for writing frame times", path.string());
+        return false;
+    }
+
+    std::vector<float> history;
+    uint64_t first_frame = 0;
+    {
+        std::lock_guard lock(mutex);
+        history = orderedFrameTimes();
+        first_frame = recorded - history.size();
+    }
+
+    file << "frame,milliseconds\n";
+    for (size_t i = 0; i < history.size(); i++) {
+        file << std::format("{},{:.4f}\n", first_frame + i, history[i]);
+    }
+
+    Log::info("Wrote {} frame times to {}", history.size(), path.string());
+    return true;
+}
+
+} // namespace Engine
@@ -0,0 +1,65 @@
+#pragma once
+
+#include "../constructors.hpp"
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <mutex>
+#include <vector>
+
+namespace Engine {
+
+// Keeps the last capacity frame times so stutter shows up in percentiles instead of
+// disappearing in an average. Recorded on the simulation thread, read from the debug
+// window on the render thread.
+
+class FrameStats {
+public:
+    constexpr static size_t DEFAULT_CAPACITY = 1024;
+    constexpr static float DEFAULT_HITCH_THRESHOLD = 50.f;
+
+    struct Summary {
+        size_t count = 0;
+        float min = 0.f;
+        float average = 0.f;
+        float p50 = 0.f;
+        float p95 = 0.f;
+        float p99 = 0.f;
+        float max = 0.f;
+    };
+
+    explicit FrameStats(size_t capacity = DEFAULT_CAPACITY);
+    DELETE_COPY(FrameStats);
+    DELETE_MOVE(FrameStats);
+
+    // Logs the profiler zones of the frame when it goes over the hitch threshold
+    void record(float delta_time);
+
+    void setHitchThreshold(float milliseconds);
+    float getHitchThreshold() const;
+    size_t getHitchCount() const;
+
+    Summary getSummary() const;
+    // Frame times in milliseconds, oldest first
+    std::vector<float> getHistory() const;
+    std::vector<float> getHistogram(size_t bins, float max_milliseconds) const;
+
+    bool exportCsv(const std::filesystem::path& path) const;
+
+private:
+    void logHitch(float milliseconds) const;
+    // Expects the mutex to be held
+    std::vector<float> orderedFrameTimes() const;
+
+    std::atomic<float> hitch_threshold = DEFAULT_HITCH_THRESHOLD;
+    std::atomic<size_t> hitch_count = 0;
+
+    mutable std::mutex mutex;
+    size_t capacity;
+    std::vector<float> frame_times;
+    size_t next = 0;
+    uint64_t recorded = 0;
+};
+
+} // namespace Engine
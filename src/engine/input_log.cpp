@@ -0,0 +1,142 @@
+#include <pch.hpp>
+
+#include "input_log.hpp"
+#include <array>
+#include <cstring>
+
+namespace Engine {
+
+constexpr std::array<char, 4> INPUT_LOG_MAGIC = { 'G', 'I', 'N', 'P' };
+constexpr char FRAME_RECORD = 'F';
+constexpr char EVENT_RECORD = 'E';
+
+// Every member of the SDL_Event union starts at offset 0, so the type specific struct is
+// just the first size bytes of the event
+
+static size_t eventPayloadSize(uint32_t type)
+{
+    switch (type) {
+    case SDL_KEYDOWN:
+    case SDL_KEYUP:
+        return sizeof(SDL_KeyboardEvent);
+    case SDL_TEXTINPUT:
+        return sizeof(SDL_TextInputEvent);
+    case SDL_MOUSEMOTION:
+        return sizeof(SDL_MouseMotionEvent);
+    case SDL_MOUSEBUTTONDOWN:
+    case SDL_MOUSEBUTTONUP:
+        return sizeof(SDL_MouseButtonEvent);
+    case SDL_MOUSEWHEEL:
+        return sizeof(SDL_MouseWheelEvent);
+    case SDL_QUIT:
+        return sizeof(SDL_QuitEvent);
+    default:
+        return 0;
+    }
+}
+
+template <typename T>
+static void writeValue(std::ofstream& file, const T& value)
+{
+    file.write(reinterpret_cast<const char*>(&value), sizeof(T));
+}
+
+template <typename T>
+static bool readValue(std::ifstream& file, T& value)
+{
+    return static_cast<bool>(file.read(reinterpret_cast<char*>(&value), sizeof(T)));
+}
+
+InputRecorder::InputRecorder(const std::filesystem::path& path)
+    : file(path, std::ios::binary), path(path)
+{
+    if (!file) {
+        Log::error("Failed to open input log \"{}\" for recording", path.string());
+        std::exit(EXIT_FAILURE);
+    }
+    file.write(INPUT_LOG_MAGIC.data(), INPUT_LOG_MAGIC.size());
+    writeValue(file, INPUT_LOG_VERSION);
+    Log::info("Recording input to \"{}\"", path.string());
+}
+
+InputRecorder::~InputRecorder()
+{
+    file.flush();
+    Log::info("Recorded {} frames and {} events to \"{}\"", frames, events, path.string());
+}
+
+void InputRecorder::beginFrame(float delta_time)
+{
+    writeValue(file, FRAME_RECORD);
+    writeValue(file, delta_time);
+    frames++;
+}
+
+void InputRecorder::recordEvent(const SDL_Event& event)
+{
+    const size_t size = eventPayloadSize(event.type);
+    if (size == 0) {
+        return;
+    }
+    writeValue(file, EVENT_RECORD);
+    writeValue(file, static_cast<uint32_t>(event.type));
+    writeValue(file, static_cast<uint16_t>(size));
+    file.write(reinterpret_cast<const char*>(&event), static_cast<std::streamsize>(size));
+    events++;
+}
+
+InputReplay::InputReplay(const std::filesystem::path& path)
+    : file(path, std::ios::binary), path(path)
+{
+    if (!file) {
+        Log::error("Failed to open input log \"{}\" for replay", path.string());
+        std::exit(EXIT_FAILURE);
+    }
+
+    std::array<char, 4> magic {};
+    uint32_t version = 0;
+    file.read(magic.data(), magic.size());
+    if (!file || magic != INPUT_LOG_MAGIC || !readValue(file, version)) {
+        Log::error("\"{}\" is not an input log", path.string());
+        std::exit(EXIT_FAILURE);
+    }
+    if (version != INPUT_LOG_VERSION) {
+        Log::error("Input log \"{}\" is version {}, expected {}", path.string(), version, INPUT_LOG_VERSION);
+        std::exit(EXIT_FAILURE);
+    }
+    Log::info("Replaying input from \"{}\"", path.string());
+}
+
+std::optional<InputReplay::Frame> InputReplay::nextFrame()
+{
+    char tag = 0;
+    Frame frame;
+    if (!readValue(file, tag) || tag != FRAME_RECORD || !readValue(file, frame.delta_time)) {
+        Log::info("Input replay finished after {} frames", frames);
+        return std::nullopt;
+    }
+
+    while (file.peek() == EVENT_RECORD) {
+        uint32_t type = 0;
+        uint16_t size = 0;
+        file.get();
+        if (!readValue(file, type) || !readValue(file, size) || size > sizeof(SDL_Event)) {
+            Log::error("Input log \"{}\" is corrupt at frame {}", path.string(), frames);
+            return std::nullopt;
+        }
+
+        SDL_Event event;
+        std::memset(&event, 0, sizeof(event));
+        if (!file.read(reinterpret_cast<char*>(&event), size)) {
+            Log::error("Input log \"{}\" is truncated at frame {}", path.string(), frames);
+            return std::nullopt;
+        }
+        event.type = type;
+        frame.events.push_back(event);
+    }
+
+    frames++;
+    return frame;
+}
+
+} // namespace Engine
@@ -0,0 +1,63 @@
+#pragma once
+
+#include "../constructors.hpp"
+#include <SDL.h>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <optional>
+#include <vector>
+
+namespace Engine {
+
+// Binary log of everything that drives the simulation from outside: each frame's delta
+// time and the SDL input events handled during it. Replaying one feeds the exact same
+// sequence back in so runs can be reproduced and compared across builds.
+//
+// Layout is a header followed by records, all little endian as written by the host:
+//   header: "GINP" magic, u32 version
+//   frame:  u8 'F', f32 delta_time
+//   event:  u8 'E', u32 SDL event type, u16 size, the event's type specific struct
+// Events belong to the frame record before them. Only input and quit events are kept,
+// the rest either carry pointers or don't affect the simulation.
+
+constexpr uint32_t INPUT_LOG_VERSION = 1;
+
+class InputRecorder {
+public:
+    explicit InputRecorder(const std::filesystem::path& path);
+    ~InputRecorder();
+    DELETE_COPY(InputRecorder);
+    DELETE_MOVE(InputRecorder);
+
+    void beginFrame(float delta_time);
+    void recordEvent(const SDL_Event& event);
+
+private:
+    std::ofstream file;
+    std::filesystem::path path;
+    uint64_t frames = 0;
+    uint64_t events = 0;
+};
+
+class InputReplay {
+public:
+    struct Frame {
+        float delta_time = 0.f;
+        std::vector<SDL_Event> events;
+    };
+
+    explicit InputReplay(const std::filesystem::path& path);
+    DELETE_COPY(InputReplay);
+    DELETE_MOVE(InputReplay);
+
+    // Empty once the log runs out
+    std::optional<Frame> nextFrame();
+
+private:
+    std::ifstream file;
+    std::filesystem::path path;
+    uint64_t frames = 0;
+};
+
+} // namespace Engine
@@ -0,0 +1,207 @@
+#include <pch.hpp>
+
+#include "job_system.hpp"
+#include "../profiler.hpp"
+#include <algorithm>
+#include <limits>
+
+namespace Engine {
+
+constexpr size_t NO_WORKER = std::numeric_limits<size_t>::max();
+
+// Workers of another system count as outside threads, their index means nothing here
+struct CurrentWorker {
+    const JobSystem* system = nullptr;
+    size_t index = NO_WORKER;
+};
+
+thread_local CurrentWorker current_worker;
+
+bool JobCounter::isDone() const
+{
+    return remaining.load(std::memory_order_acquire) == 0;
+}
+
+void JobCounter::add(size_t count)
+{
+    remaining.fetch_add(count, std::memory_order_relaxed);
+}
+
+// The counter can be destroyed as soon as a waiter sees zero, so the last release only
+// publishes it once it's done with the continuations. Waiters take the lock before
+// returning to make sure this has let go of it too.
+
+void JobCounter::release(JobSystem& system)
+{
+    size_t count = remaining.load(std::memory_order_relaxed);
+    while (count > 1) {
+        if (remaining.compare_exchange_weak(count, count - 1, std::memory_order_acq_rel, std::memory_order_relaxed)) {
+            return;
+        }
+    }
+
+    std::vector<Job> ready;
+    {
+        std::lock_guard lock(mutex);
+        ready.swap(continuations);
+        remaining.fetch_sub(1, std::memory_order_acq_rel);
+    }
+    for (auto& job : ready) {
+        system.enqueue(std::move(job));
+    }
+}
+
+bool JobCounter::tryDefer(Job&& job)
+{
+    std::lock_guard lock(mutex);
+    if (isDone()) {
+        return false;
+    }
+    continuations.push_back(std::move(job));
+    return true;
+}
+
+JobSystem::JobSystem(size_t worker_count)
+{
+    worker_count = std::max<size_t>(worker_count, 1);
+
+    // One queue per worker plus a shared one that threads outside the pool push into
+    for (size_t i = 0; i < worker_count + 1; i++) {
+        queues.push_back(std::make_unique<WorkQueue>());
+    }
+
+    for (size_t i = 0; i < worker_count; i++) {
+        workers.emplace_back(&JobSystem::workerLoop, this, i);
+    }
+
+    Log::info(Log::Category::Jobs, "Started job system with {} workers", worker_count);
+}
+
+JobSystem::~JobSystem()
+{
+    running = false;
+    {
+        std::lock_guard lock(sleep_mutex);
+    }
+    sleep_condition.notify_all();
+
+    for (auto& worker : workers) {
+        worker.join();
+    }
+}
+
+size_t JobSystem::defaultWorkerCount()
+{
+    const size_t cores = std::thread::hardware_concurrency();
+    return cores > 1 ? cores - 1 : 1;
+}
+
+size_t JobSystem::getWorkerCount() const
+{
+    return workers.size();
+}
+
+void JobSystem::schedule(std::function<void()> function, JobCounter* counter, JobCounter* dependency)
+{
+    if (counter != nullptr) {
+        counter->add(1);
+    }
+
+    Job job { std::move(function), counter };
+    if (dependency != nullptr && dependency->tryDefer(std::move(job))) {
+        return;
+    }
+    enqueue(std::move(job));
+}
+
+void JobSystem::wait(const JobCounter& counter)
+{
+    const size_t home_queue = getHomeQueue();
+    while (!counter.isDone()) {
+        if (!tryRunOne(home_queue)) {
+            std::this_thread::yield();
+        }
+    }
+    std::lock_guard lock(counter.mutex);
+}
+
+void JobSystem::parallelFor(size_t begin, size_t end, size_t grain_size, const std::function<void(size_t, size_t)>& function)
+{
+    if (begin >= end) {
+        return;
+    }
+    grain_size = std::max<size_t>(grain_size, 1);
+
+    // The first chunk runs on the calling thread, no point in queueing it
+    const size_t first_end = std::min(begin + grain_size, end);
+
+    JobCounter counter;
+    for (size_t chunk = first_end; chunk < end; chunk += grain_size) {
+        const size_t chunk_end = std::min(chunk + grain_size, end);
+        schedule([&function, chunk, chunk_end]() { function(chunk, chunk_end); }, &counter);
+    }
+
+    function(begin, first_end);
+    wait(counter);
+}
+
+void JobSystem::workerLoop(size_t index)
+{
+    current_worker = CurrentWorker { this, index };
+    GLOBAL_PROFILER.setThreadName(std::format("Worker {}", index));
+
+    while (running) {
+        if (tryRunOne(index)) {
+            continue;
+        }
+
+        std::unique_lock lock(sleep_mutex);
+        sleep_condition.wait(lock, [this]() { return queued > 0 || !running; });
+    }
+}
+
+void JobSystem::enqueue(Job&& job)
+{
+    const size_t queue = getHomeQueue();
+    queued.fetch_add(1, std::memory_order_release);
+    queues[queue]->push(std::move(job));
+
+    // Taking the lock makes sure a worker can't check for work and go to sleep between
+    // the push and the notify
+    {
+        std::lock_guard lock(sleep_mutex);
+    }
+    sleep_condition.notify_one();
+}
+
+size_t JobSystem::getHomeQueue() const
+{
+    return current_worker.system == this ? current_worker.index : queues.size() - 1;
+}
+
+bool JobSystem::tryRunOne(size_t home_queue)
+{
+    std::optional<Job> job = queues[home_queue]->pop();
+    for (size_t i = 1; !job && i < queues.size(); i++) {
+        job = queues[(home_queue + i) % queues.size()]->steal();
+    }
+
+    if (!job) {
+        return false;
+    }
+
+    queued.fetch_sub(1, std::memory_order_relaxed);
+    run(*job);
+    return true;
+}
+
+void JobSystem::run(Job& job)
+{
+    PROFILE_SCOPE("JobSystem::run");
+    job.function();
+    if (job.counter != nullptr) {
+        job.counter->release(*this);
+    }
+}
+
+} // namespace Engine
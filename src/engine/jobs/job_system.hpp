@@ -0,0 +1,80 @@
+#pragma once
+
+#include "work_queue.hpp"
+#include "../../constructors.hpp"
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace Engine {
+
+class JobSystem;
+
+// Counts outstanding jobs. Jobs scheduled with a dependency on a counter are parked on
+// it and only get queued once it reaches zero.
+
+class JobCounter {
+public:
+    JobCounter() = default;
+    DELETE_COPY(JobCounter);
+    DELETE_MOVE(JobCounter);
+
+    bool isDone() const;
+
+private:
+    void add(size_t count);
+    void release(JobSystem& system);
+    bool tryDefer(Job&& job);
+
+    std::atomic<size_t> remaining = 0;
+    mutable std::mutex mutex;
+    std::vector<Job> continuations;
+
+    friend JobSystem;
+};
+
+class JobSystem {
+public:
+    // Defaults to one worker per core, minus the thread that waits on jobs since it
+    // helps out while waiting
+    explicit JobSystem(size_t worker_count = defaultWorkerCount());
+    ~JobSystem();
+    DELETE_COPY(JobSystem);
+    DELETE_MOVE(JobSystem);
+
+    static size_t defaultWorkerCount();
+    size_t getWorkerCount() const;
+
+    void schedule(std::function<void()> function, JobCounter* counter = nullptr, JobCounter* dependency = nullptr);
+
+    // Runs queued jobs on the calling thread until the counter reaches zero
+    void wait(const JobCounter& counter);
+
+    // Splits [begin, end) into chunks of at most grain_size and blocks until all of them ran
+    void parallelFor(size_t begin, size_t end, size_t grain_size, const std::function<void(size_t, size_t)>& function);
+
+private:
+    void workerLoop(size_t index);
+    void enqueue(Job&& job);
+    // The calling worker's own queue, or the shared one for threads outside this system
+    size_t getHomeQueue() const;
+    bool tryRunOne(size_t home_queue);
+    void run(Job& job);
+
+    std::vector<std::unique_ptr<WorkQueue>> queues;
+    std::vector<std::thread> workers;
+
+    std::atomic<size_t> queued = 0;
+    std::atomic<bool> running = true;
+    std::mutex sleep_mutex;
+    std::condition_variable sleep_condition;
+
+    friend JobCounter;
+};
+
+} // namespace Engine
@@ -0,0 +1,60 @@
+#pragma once
+
+#include "../../constructors.hpp"
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <optional>
+
+namespace Engine {
+
+class JobCounter;
+
+struct Job {
+    std::function<void()> function;
+    JobCounter* counter = nullptr;
+};
+
+// Per worker queue. The owning worker pushes and pops from the back so it keeps working
+// on whatever is hot in its cache, idle workers steal the oldest work from the front.
+
+class WorkQueue {
+public:
+    WorkQueue() = default;
+    DELETE_COPY(WorkQueue);
+    DELETE_MOVE(WorkQueue);
+
+    void push(Job job)
+    {
+        std::lock_guard lock(mutex);
+        jobs.push_back(std::move(job));
+    }
+
+    std::optional<Job> pop()
+    {
+        std::lock_guard lock(mutex);
+        if (jobs.empty()) {
+            return std::nullopt;
+        }
+        Job job = std::move(jobs.back());
+        jobs.pop_back();
+        return job;
+    }
+
+    std::optional<Job> steal()
+    {
+        std::lock_guard lock(mutex);
+        if (jobs.empty()) {
+            return std::nullopt;
+        }
+        Job job = std::move(jobs.front());
+        jobs.pop_front();
+        return job;
+    }
+
+private:
+    std::mutex mutex;
+    std::deque<Job> jobs;
+};
+
+} // namespace Engine
@@ -0,0 +1,89 @@
+#include <pch.hpp>
+
+#include "kinematics.hpp"
+#include "profiler.hpp"
+#include "sprite_kernels.hpp"
+
+namespace Engine {
+
+KinematicsSystem::KinematicsSystem(EntityRegistry& registry, SpriteManager& sprite_manager)
+    : registry(registry), sprite_manager(sprite_manager)
+{
+
+}
+
+void KinematicsSystem::clear()
+{
+    bodies.clear();
+    sprites.clear();
+    velocity_x.clear();
+    velocity_y.clear();
+    acceleration_x.clear();
+    acceleration_y.clear();
+    damping.clear();
+    max_speed.clear();
+}
+
+void KinematicsSystem::step(float delta_time)
+{
+    PROFILE_SCOPE("KinematicsSystem::step");
+
+    clear();
+    // Sprites destroyed directly rather than through their entity are skipped, ids carry a
+    // generation so one whose slot has been reused doesn't count as alive
+    registry.view<Kinematics, Sprite>().each([&](Entity, Kinematics& body, const Sprite& sprite) {
+        if (!sprite_manager.isAlive(sprite.getId())) {
+            return;
+        }
+        bodies.push_back(&body);
+        sprites.push_back(sprite.getId());
+        velocity_x.push_back(body.velocity.x);
+        velocity_y.push_back(body.velocity.y);
+        acceleration_x.push_back(body.acceleration.x);
+        acceleration_y.push_back(body.acceleration.y);
+        damping.push_back(body.damping);
+        max_speed.push_back(body.max_speed);
+    });
+
+    const size_t count = bodies.size();
+    if (count == 0) {
+        return;
+    }
+    x.resize(count);
+    y.resize(count);
+    sprite_manager.getPositions(sprites, x.data(), y.data());
+
+    const SpriteKernels& kernels = getSpriteKernels();
+    kernels.accelerate(
+        velocity_x.data(), velocity_y.data(),
+        acceleration_x.data(), acceleration_y.data(),
+        damping.data(), max_speed.data(),
+        count, delta_time
+    );
+    kernels.integrate(x.data(), y.data(), velocity_x.data(), velocity_y.data(), count, delta_time);
+
+    // Bodies at rest are left out of the write so they don't dirty their sprites
+    size_t moved = 0;
+    for (size_t i = 0; i < count; i++) {
+        const bool coasting = acceleration_x[i] == 0.f && acceleration_y[i] == 0.f;
+        if (coasting && velocity_x[i] * velocity_x[i] + velocity_y[i] * velocity_y[i] < REST_SPEED * REST_SPEED) {
+            velocity_x[i] = 0.f;
+            velocity_y[i] = 0.f;
+        }
+        bodies[i]->velocity = glm::vec2(velocity_x[i], velocity_y[i]);
+        if (velocity_x[i] != 0.f || velocity_y[i] != 0.f) {
+            sprites[moved] = sprites[i];
+            x[moved] = x[i];
+            y[moved] = y[i];
+            moved++;
+        }
+    }
+    sprite_manager.setPositions(std::span(sprites.data(), moved), x.data(), y.data());
+}
+
+size_t KinematicsSystem::getCount() const
+{
+    return bodies.size();
+}
+
+} // namespace Engine
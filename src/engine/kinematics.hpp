@@ -0,0 +1,59 @@
+#pragma once
+
+#include "ecs.hpp"
+#include "sprite.hpp"
+#include "../constructors.hpp"
+#include <limits>
+#include <vector>
+#include <glm/glm.hpp>
+
+namespace Engine {
+
+// Movement inputs and state for an entity that also has a Sprite. Each step the velocity
+// changes by acceleration - velocity * damping, gets clamped to max_speed and then moves
+// the sprite.
+
+struct Kinematics {
+    glm::vec2 velocity = glm::vec2(0.f, 0.f);
+    glm::vec2 acceleration = glm::vec2(0.f, 0.f);
+    float damping = 0.f;
+    float max_speed = std::numeric_limits<float>::infinity();
+};
+
+// Gathers every entity with both components into columns, runs the accelerate and
+// integrate kernels over them and writes the results back. The columns are kept between
+// steps so nothing is allocated once they've grown.
+
+class KinematicsSystem {
+public:
+    // Damping only ever gets close to zero, bodies coasting slower than this are stopped
+    // so they stop dirtying their sprites
+    constexpr static float REST_SPEED = 0.01f;
+
+    KinematicsSystem(EntityRegistry& registry, SpriteManager& sprite_manager);
+    DELETE_COPY(KinematicsSystem);
+    DELETE_MOVE(KinematicsSystem);
+
+    void step(float delta_time);
+    // Entities the last step went over, moving or not
+    size_t getCount() const;
+
+private:
+    void clear();
+
+    EntityRegistry& registry;
+    SpriteManager& sprite_manager;
+
+    std::vector<Kinematics*> bodies;
+    std::vector<SpriteId> sprites;
+    std::vector<float> x;
+    std::vector<float> y;
+    std::vector<float> velocity_x;
+    std::vector<float> velocity_y;
+    std::vector<float> acceleration_x;
+    std::vector<float> acceleration_y;
+    std::vector<float> damping;
+    std::vector<float> max_speed;
+};
+
+} // namespace Engine
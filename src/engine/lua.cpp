@@ -3,10 +3,14 @@
 #include "lua.hpp"
 #include "keycodes.hpp"
 #include "logging.hpp"
+#include "profiler.hpp"
 #include "../platform.hpp"
+#include "../gfx/window.hpp"
+#include "../resource/texture.hpp"
 #include <sol/forward.hpp>
 #include <sol/protected_function_result.hpp>
 #include <sol/trampoline.hpp>
+#include <algorithm>
 #include <sstream>
 
 namespace Engine {
@@ -14,14 +18,100 @@ namespace Engine {
 void Lua::panic(std::optional<std::string> maybe_message)
 {
     if (maybe_message.has_value()) {
-        Log::error("Lua panic: {}", *maybe_message);
+        Log::error(Log::Category::Lua, "Lua panic: {}", *maybe_message);
     } else {
-        Log::error("Lua has panicked without a message. :-)");
+        Log::error(Log::Category::Lua, "Lua has panicked without a message. :-)");
     }
 }
 
-Lua::Lua(SpriteManager& sprite_manager)
+// Conversions between plain Lua arrays and contiguous floats for the bulk APIs, the
+// FloatBuffer overloads skip these entirely
+
+std::vector<float> readFloatArray(const sol::table& table)
+{
+    std::vector<float> values(table.size());
+    size_t invalid = 0;
+    for (size_t i = 0; i < values.size(); i++) {
+        const sol::object value = table.raw_get<sol::object>(i + 1);
+        if (value.get_type() == sol::type::number) {
+            values[i] = value.as<float>();
+        } else {
+            values[i] = 0.f;
+            invalid++;
+        }
+    }
+    if (invalid > 0) {
+        Log::warn(Log::Category::Lua, "{} of {} array entries weren't numbers, using 0 for them", invalid, values.size());
+    }
+    return values;
+}
+
+sol::table writeFloatArray(sol::this_state state, std::span<const float> values, sol::optional<sol::table> maybe_out)
+{
+    sol::table out = maybe_out ? *maybe_out : sol::state_view(state).create_table(static_cast<int>(values.size()), 0);
+    for (size_t i = 0; i < values.size(); i++) {
+        out.raw_set(i + 1, values[i]);
+    }
+    return out;
+}
+
+sol::table writeSpriteArray(sol::this_state state, std::vector<Sprite> sprites)
 {
+    sol::table out = sol::state_view(state).create_table(static_cast<int>(sprites.size()), 0);
+    for (size_t i = 0; i < sprites.size(); i++) {
+        out.raw_set(i + 1, std::move(sprites[i]));
+    }
+    return out;
+}
+
+// Scripts hold on to the entity rather than the component, components move around in
+// their pool as others are added and removed. Reads of a removed component give the
+// defaults and writes are dropped.
+
+struct KinematicsHandle {
+    EntityRegistry* registry;
+    Entity entity;
+
+    Kinematics get() const
+    {
+        const Kinematics* body = registry->tryGet<Kinematics>(entity);
+        return body ? *body : Kinematics {};
+    }
+
+    template <typename Fn>
+    void set(Fn&& fn) const
+    {
+        if (Kinematics* body = registry->tryGet<Kinematics>(entity)) {
+            fn(*body);
+        }
+    }
+};
+
+// Fields missing from the table keep their defaults
+
+Kinematics readKinematics(const sol::object& value)
+{
+    Kinematics body;
+    if (value.get_type() != sol::type::table) {
+        return body;
+    }
+    const sol::table table = value.as<sol::table>();
+    body.velocity = table.get_or("velocity", body.velocity);
+    body.acceleration = table.get_or("acceleration", body.acceleration);
+    body.damping = table.get_or("damping", body.damping);
+    body.max_speed = table.get_or("max_speed", body.max_speed);
+    return body;
+}
+
+Lua::Lua(SpriteManager& sprite_manager, CollisionWorld& collision, EntityRegistry& registry, ResourceManager& resource_manager, Camera& camera, FixedTimestep& timestep, Window& window)
+    : sprite_manager(sprite_manager), registry(registry), timestep(timestep)
+{
+    // Sprites are the one native component scripts get by name
+    registry.getPool<Sprite>();
+    registry.getPool<Kinematics>();
+    script_components["Sprite"] = componentId<Sprite>();
+    script_components["Kinematics"] = componentId<Kinematics>();
+
     lua.set_panic(sol::c_call<decltype(&Lua::panic), &Lua::panic>);
 
     lua.set_exception_handler([](
@@ -30,9 +120,9 @@ Lua::Lua(SpriteManager& sprite_manager)
         std::string_view description) -> int
     {
         if (maybe_exception.has_value()) {
-            Log::error("Lua exception: {}", (*maybe_exception).what());
+            Log::error(Log::Category::Lua, "Lua exception: {}", (*maybe_exception).what());
         } else {
-            Log::error("Lua error description: {}", description);
+            Log::error(Log::Category::Lua, "Lua error description: {}", description);
         }
         return 0;
     });
@@ -56,6 +146,164 @@ Lua::Lua(SpriteManager& sprite_manager)
             return sprite_manager.createSprite();
         };
 
+        engine["CreateSprites"] = [&sprite_manager](size_t count) -> SpriteBatch {
+            return sprite_manager.createSprites(count);
+        };
+
+        // Rect is given by its min and max corners, results come back in no particular order.
+        // The handles point at the same sprites as any the script already holds, destroying
+        // through one leaves the others dead rather than dangling.
+        engine["QuerySprites"] = [&sprite_manager](glm::vec2 min, glm::vec2 max, sol::this_state state) {
+            return writeSpriteArray(state, sprite_manager.querySprites(SpriteBounds { .min = min, .max = max }));
+        };
+
+        engine["QuerySpritesInRadius"] = [&sprite_manager](glm::vec2 center, float radius, sol::this_state state) {
+            return writeSpriteArray(state, sprite_manager.querySprites(center, radius));
+        };
+
+        // Colliders are centred on the sprite and replace any it already has
+        engine["SetBoxCollider"] = [&collision](const Sprite& sprite, glm::vec2 half_size) {
+            collision.setCollider(sprite.getId(), Collider { .shape = ColliderShape::Box, .half_extents = half_size });
+        };
+
+        engine["SetCircleCollider"] = [&collision](const Sprite& sprite, float radius) {
+            collision.setCollider(sprite.getId(), Collider { .shape = ColliderShape::Circle, .radius = radius });
+        };
+
+        engine["RemoveCollider"] = [&collision](const Sprite& sprite) {
+            collision.removeCollider(sprite.getId());
+        };
+
+        // Entities are plain integers, a destroyed entity's number never comes back
+        engine["CreateEntity"] = [&registry]() -> Entity {
+            return registry.create();
+        };
+
+        engine["DestroyEntity"] = [&registry](Entity entity) {
+            registry.destroy(entity);
+        };
+
+        engine["IsEntityAlive"] = [&registry](Entity entity) -> bool {
+            return registry.isAlive(entity);
+        };
+
+        // Script components can hold any Lua value, tables are stored by reference
+        engine["DefineComponent"] = [this](const std::string& name) {
+            if (script_components.contains(name)) {
+                Log::warn(Log::Category::Lua, "Component \"{}\" is already defined", name);
+                return;
+            }
+            script_components[name] = this->registry.createPool<sol::object>();
+        };
+
+        // Giving an entity a sprite makes the entity own it, the sprite is destroyed along
+        // with the component. Script handles to it stay usable until then and go dead after,
+        // setting the sprite the entity already has does nothing. Kinematics are set from a
+        // table of their fields.
+        engine["SetComponent"] = [this](Entity entity, const std::string& name, sol::object value) {
+            const std::optional<ComponentId> id = findComponent(name);
+            if (!id || !this->registry.isAlive(entity)) {
+                return;
+            }
+            if (*id == componentId<Kinematics>()) {
+                this->registry.emplace<Kinematics>(entity, readKinematics(value));
+            } else if (*id != componentId<Sprite>()) {
+                this->registry.getPool<sol::object>(*id).emplace(entity, std::move(value));
+            } else if (value.is<Sprite>()) {
+                const SpriteId sprite = value.as<const Sprite&>().getId();
+                if (!this->sprite_manager.isAlive(sprite)) {
+                    Log::warn(Log::Category::Lua, "Sprite component can't be set to a destroyed sprite");
+                    return;
+                }
+                const Sprite* current = this->registry.tryGet<Sprite>(entity);
+                if (current == nullptr || current->getId() != sprite) {
+                    this->registry.emplace<Sprite>(entity, this->sprite_manager.getSprite(sprite));
+                }
+            } else {
+                Log::warn(Log::Category::Lua, "Sprite component has to be set to a Sprite");
+            }
+        };
+
+        engine["GetComponent"] = [this](Entity entity, const std::string& name, sol::this_state state) -> sol::object {
+            const std::optional<ComponentId> id = findComponent(name);
+            if (!id || !this->registry.findPool(*id)->contains(entity)) {
+                return sol::lua_nil;
+            }
+            return getComponent(state, *id, entity);
+        };
+
+        engine["RemoveComponent"] = [this](Entity entity, const std::string& name) {
+            if (const std::optional<ComponentId> id = findComponent(name)) {
+                this->registry.findPool(*id)->remove(entity);
+            }
+        };
+
+        // Entities with every named component, returned as one array of entities followed by
+        // one array per component in the same order, all in a single call
+        engine["Query"] = [this](sol::variadic_args names, sol::this_state state) {
+            sol::state_view lua(state);
+            sol::variadic_results results;
+
+            std::vector<ComponentId> ids;
+            std::vector<const ComponentPoolBase*> pools;
+            for (const auto& name : names) {
+                const std::optional<ComponentId> id = findComponent(name.as<std::string>());
+                if (!id) {
+                    return results;
+                }
+                ids.push_back(*id);
+                pools.push_back(this->registry.findPool(*id));
+            }
+            if (pools.empty()) {
+                return results;
+            }
+
+            const ComponentPoolBase* lead = *std::min_element(pools.begin(), pools.end(), [](const auto* lhs, const auto* rhs) {
+                return lhs->size() < rhs->size();
+            });
+            sol::table entities = lua.create_table(static_cast<int>(lead->size()), 0);
+            std::vector<sol::table> columns;
+            for (size_t i = 0; i < ids.size(); i++) {
+                columns.push_back(lua.create_table(static_cast<int>(lead->size()), 0));
+            }
+
+            size_t count = 0;
+            for (const Entity entity : lead->getEntities()) {
+                if (!std::all_of(pools.begin(), pools.end(), [&](const auto* pool) { return pool->contains(entity); })) {
+                    continue;
+                }
+                count++;
+                entities.raw_set(count, entity);
+                for (size_t i = 0; i < ids.size(); i++) {
+                    columns[i].raw_set(count, getComponent(state, ids[i], entity));
+                }
+            }
+
+            results.push_back(entities);
+            for (sol::table& column : columns) {
+                results.push_back(column);
+            }
+            return results;
+        };
+
+        // Nil when the image can't be loaded or doesn't fit in an atlas page
+        engine["LoadTexture"] = [&sprite_manager, &resource_manager](const std::string& path) -> sol::optional<AtlasRegion> {
+            const Texture& texture = resource_manager.load<Texture>(std::filesystem::path("textures") / path);
+            if (const std::optional<AtlasRegion> region = sprite_manager.getAtlas().add(texture)) {
+                return *region;
+            }
+            Log::warn(Log::Category::Lua, "Texture \"{}\" could not be added to the atlas", path);
+            return sol::nullopt;
+        };
+
+        engine["FloatBuffer"] = sol::overload(
+            [](size_t size) { return FloatBuffer(size); },
+            [](const sol::table& values) { return FloatBuffer(readFloatArray(values)); }
+        );
+
+        // Shared with the engine, changes show up from the next frame drawn
+        engine["Camera"] = &camera;
+
         engine["Events"] = lua.create_table();
         for (auto& [name, event] : builtin_events) {
             engine["Events"][name] = &event;
@@ -72,8 +320,16 @@ Lua::Lua(SpriteManager& sprite_manager)
             return key_state[keycode];
         };
 
-        engine["SetVSync"] = [](bool enable) {
-            SDL_GL_SetSwapInterval(enable ? 1 : 0);
+        engine["SetVSync"] = [&window](bool enable) {
+            window.setVSync(enable);
+        };
+
+        engine["SetTickRate"] = [&timestep](float tick_rate) {
+            timestep.setTickRate(tick_rate);
+        };
+
+        engine["GetTickRate"] = [&timestep]() -> float {
+            return timestep.getTickRate();
         };
 
         return engine;
@@ -81,6 +337,10 @@ Lua::Lua(SpriteManager& sprite_manager)
 
     // Overriding the builtin print function to use the engine logging
     lua["print"] = [](sol::variadic_args va, sol::this_state ts) {
+        // Skip the debug info lookup and tostring calls when nobody will see the output
+        if (!Log::GLOBAL_LOGGER.shouldLog(Log::Category::Lua, Log::Logger::Severity::Info)) {
+            return;
+        }
         std::stringstream buffer;
         sol::state_view lua(ts);
 
@@ -94,12 +354,7 @@ Lua::Lua(SpriteManager& sprite_manager)
             if (std::optional<std::string> name = debug_info["source"]) {
                 // Attempt to remove everything before the resources folder to keep logs
                 // cleaner
-                size_t folder_pos = (*name).find("resources/");
-                if (folder_pos != std::string::npos) {
-                    script_name = (*name).substr(folder_pos);
-                } else {
-                    script_name = *name;
-                }
+                script_name = trimScriptSource(*name);
             } else {
                 script_name = "[unknown_script]";
             }
@@ -119,25 +374,92 @@ Lua::Lua(SpriteManager& sprite_manager)
     };
 }
 
+Lua::~Lua()
+{
+    for (const auto& [name, id] : script_components) {
+        if (id != componentId<Sprite>()) {
+            registry.findPool(id)->clear();
+        }
+    }
+}
+
+std::optional<ComponentId> Lua::findComponent(const std::string& name) const
+{
+    const auto found = script_components.find(name);
+    if (found == script_components.end()) {
+        Log::warn(Log::Category::Lua, "Component \"{}\" hasn't been defined", name);
+        return std::nullopt;
+    }
+    return found->second;
+}
+
+// Sprites are handed out as new handles, the component keeps its own
+
+sol::object Lua::getComponent(sol::this_state state, ComponentId id, Entity entity)
+{
+    if (id == componentId<Sprite>()) {
+        return sol::make_object(state, sprite_manager.getSprite(registry.get<Sprite>(entity).getId()));
+    }
+    if (id == componentId<Kinematics>()) {
+        return sol::make_object(state, KinematicsHandle { &registry, entity });
+    }
+    return registry.getPool<sol::object>(id).get(entity);
+}
+
 void Lua::runEntryPoint(const LuaSource& source)
 {
     try {
         lua.script_file(source.getSource()); 
     } catch (const sol::error& e) {
-        Log::error("Lua compilation error: {}", e.what());
+        Log::error(Log::Category::Lua, "Lua compilation error: {}", e.what());
     }
 }
 
 void Lua::gc()
 {
+    PROFILE_SCOPE("Lua::gc");
+    profiler.update(lua.lua_state());
     lua.collect_garbage();
 }
 
+LuaProfiler& Lua::getProfiler()
+{
+    return profiler;
+}
+
 void Lua::setKeyState(KeyCode keycode, bool state)
 {
     key_state[keycode] = state;
 }
 
+// Both tables are flat lists of pairs, { a1, b1, a2, b2, ... }. Sprites destroyed since the
+// contact changed show up as false, which keeps the pairs in place.
+
+void Lua::fireCollisionEvents(std::span<const CollisionEvent> events)
+{
+    if (events.empty()) {
+        return;
+    }
+    PROFILE_SCOPE("OnCollisions");
+
+    sol::table began = lua.create_table();
+    sol::table ended = lua.create_table();
+    size_t began_count = 0;
+    size_t ended_count = 0;
+    for (const CollisionEvent& event : events) {
+        sol::table& out = event.began ? began : ended;
+        size_t& count = event.began ? began_count : ended_count;
+        for (SpriteId id : { event.a, event.b }) {
+            if (sprite_manager.isAlive(id)) {
+                out.raw_set(++count, sprite_manager.getSprite(id));
+            } else {
+                out.raw_set(++count, false);
+            }
+        }
+    }
+    builtin_events["OnCollisions"].fire(began, ended);
+}
+
 template <>
 void Lua::registerType<glm::vec2>()
 {
@@ -210,7 +532,14 @@ void Lua::registerType<Sprite>()
 {
     auto sprite = lua.new_usertype<Sprite>("Sprite");
     sprite["position"] = sol::property(&Sprite::getPosition, &Sprite::setPosition);
+    // Interpolated between ticks like the drawn sprite, for anything that has to line up
+    // with it on screen such as the camera
+    sprite["render_position"] = sol::readonly_property([this](const Sprite& self) {
+        return self.getRenderPosition(timestep.getAlpha());
+    });
     sprite["scale"] = sol::property(&Sprite::getScale, &Sprite::setScale);
+    sprite["texture"] = sol::property(&Sprite::getTexture, &Sprite::setTexture);
+    sprite["id"] = sol::readonly_property(&Sprite::getId);
     sprite["Destroy"] = &Sprite::destroy;
     sprite[sol::meta_method::equal_to] = [](const Sprite& lhs, const Sprite& rhs) {
         return lhs.getId() == rhs.getId();
@@ -220,6 +549,167 @@ void Lua::registerType<Sprite>()
     };
 }
 
+template <>
+void Lua::registerType<SpriteBatch>()
+{
+    auto batch = lua.new_usertype<SpriteBatch>("SpriteBatch");
+    batch["Count"] = &SpriteBatch::size;
+    batch["Get"] = [](const SpriteBatch& self, size_t index) -> Sprite {
+        return self.get(index - 1);
+    };
+    batch["Destroy"] = &SpriteBatch::destroy;
+    batch["SetTexture"] = &SpriteBatch::setTexture;
+    // FloatBuffers are read and written in place, tables get converted
+    batch["SetPositions"] = sol::overload(
+        [](SpriteBatch& self, const FloatBuffer& positions) {
+            self.setPositions(positions.span());
+        },
+        [](SpriteBatch& self, const sol::table& positions) {
+            self.setPositions(readFloatArray(positions));
+        }
+    );
+    batch["GetPositions"] = sol::overload(
+        [](const SpriteBatch& self, FloatBuffer& out) -> FloatBuffer {
+            self.getPositions(out.span());
+            return out;
+        },
+        [](const SpriteBatch& self, sol::optional<sol::table> out, sol::this_state state) {
+            std::vector<float> positions(self.size() * 2);
+            self.getPositions(positions);
+            return writeFloatArray(state, positions, out);
+        }
+    );
+    batch["SetScales"] = sol::overload(
+        [](SpriteBatch& self, const FloatBuffer& scales) {
+            self.setScales(scales.span());
+        },
+        [](SpriteBatch& self, const sol::table& scales) {
+            self.setScales(readFloatArray(scales));
+        }
+    );
+    batch["GetScales"] = sol::overload(
+        [](const SpriteBatch& self, FloatBuffer& out) -> FloatBuffer {
+            self.getScales(out.span());
+            return out;
+        },
+        [](const SpriteBatch& self, sol::optional<sol::table> out, sol::this_state state) {
+            std::vector<float> scales(self.size());
+            self.getScales(scales);
+            return writeFloatArray(state, scales, out);
+        }
+    );
+    batch[sol::meta_method::length] = &SpriteBatch::size;
+    batch[sol::meta_method::to_string] = [](const SpriteBatch& self) {
+        return std::format("SpriteBatch {{ count: {} }}", self.size()); 
+    };
+}
+
+// Only handed out by LoadTexture, the layer is there mostly for debugging
+
+template <>
+void Lua::registerType<AtlasRegion>()
+{
+    auto region = lua.new_usertype<AtlasRegion>("TextureRegion", sol::no_constructor);
+    region["layer"] = sol::readonly(&AtlasRegion::layer);
+    region[sol::meta_method::to_string] = [](const AtlasRegion& self) {
+        return std::format("TextureRegion {{ layer: {}, uv: ({}, {}, {}, {}) }}",
+            self.layer, self.uv_rect.x, self.uv_rect.y, self.uv_rect.z, self.uv_rect.w);
+    };
+}
+
+// Rotation is in radians
+
+template <>
+void Lua::registerType<Camera>()
+{
+    auto camera = lua.new_usertype<Camera>("Camera", sol::no_constructor);
+    camera["position"] = sol::property(&Camera::getPosition, &Camera::setPosition);
+    camera["zoom"] = sol::property(&Camera::getZoom, &Camera::setZoom);
+    camera["rotation"] = sol::property(&Camera::getRotation, &Camera::setRotation);
+    camera[sol::meta_method::to_string] = [](const Camera& self) {
+        return std::format("Camera {{ position: ({}, {}), zoom: {}, rotation: {} }}",
+            self.getPosition().x, self.getPosition().y, self.getZoom(), self.getRotation());
+    };
+}
+
+// Only the inputs need setting each step, SetAcceleration saves building a Vec2 for it
+
+template <>
+void Lua::registerType<Kinematics>()
+{
+    auto kinematics = lua.new_usertype<KinematicsHandle>("Kinematics", sol::no_constructor);
+    kinematics["velocity"] = sol::property(
+        [](const KinematicsHandle& self) { return self.get().velocity; },
+        [](const KinematicsHandle& self, glm::vec2 velocity) { self.set([&](Kinematics& body) { body.velocity = velocity; }); }
+    );
+    kinematics["acceleration"] = sol::property(
+        [](const KinematicsHandle& self) { return self.get().acceleration; },
+        [](const KinematicsHandle& self, glm::vec2 acceleration) { self.set([&](Kinematics& body) { body.acceleration = acceleration; }); }
+    );
+    kinematics["damping"] = sol::property(
+        [](const KinematicsHandle& self) { return self.get().damping; },
+        [](const KinematicsHandle& self, float damping) { self.set([&](Kinematics& body) { body.damping = damping; }); }
+    );
+    kinematics["max_speed"] = sol::property(
+        [](const KinematicsHandle& self) { return self.get().max_speed; },
+        [](const KinematicsHandle& self, float max_speed) { self.set([&](Kinematics& body) { body.max_speed = max_speed; }); }
+    );
+    kinematics["SetAcceleration"] = [](const KinematicsHandle& self, float x, float y) {
+        self.set([&](Kinematics& body) { body.acceleration = glm::vec2(x, y); });
+    };
+    kinematics[sol::meta_method::to_string] = [](const KinematicsHandle& self) {
+        const Kinematics body = self.get();
+        return std::format("Kinematics {{ entity: {}, velocity: ({}, {}), acceleration: ({}, {}) }}",
+            self.entity, body.velocity.x, body.velocity.y, body.acceleration.x, body.acceleration.y);
+    };
+}
+
+// Indices are 1 based on the Lua side like everything else there, slices include both ends
+// like string.sub
+
+template <>
+void Lua::registerType<FloatBuffer>()
+{
+    auto buffer = lua.new_usertype<FloatBuffer>("FloatBuffer", sol::factories(
+        [](size_t size) { return FloatBuffer(size); },
+        [](const sol::table& values) { return FloatBuffer(readFloatArray(values)); }
+    ));
+    buffer["Size"] = &FloatBuffer::size;
+    buffer["Get"] = [](const FloatBuffer& self, size_t index) {
+        return self.get(index - 1);
+    };
+    buffer["Set"] = [](FloatBuffer& self, size_t index, float value) {
+        self.set(index - 1, value);
+    };
+    buffer["Slice"] = [](const FloatBuffer& self, size_t first, size_t last) {
+        return self.slice(first - 1, last);
+    };
+    buffer["Clone"] = &FloatBuffer::clone;
+    buffer["Fill"] = &FloatBuffer::fill;
+    buffer["Add"] = &FloatBuffer::add;
+    buffer["Sub"] = &FloatBuffer::subtract;
+    buffer["Mul"] = &FloatBuffer::multiply;
+    buffer["AddScaled"] = &FloatBuffer::addScaled;
+    buffer["Scale"] = &FloatBuffer::scale;
+    buffer["Sum"] = &FloatBuffer::sum;
+    buffer["Dot"] = &FloatBuffer::dot;
+    buffer["Min"] = &FloatBuffer::min;
+    buffer["Max"] = &FloatBuffer::max;
+    buffer["ToTable"] = [](const FloatBuffer& self, sol::this_state state) {
+        return writeFloatArray(state, self.span(), sol::nullopt);
+    };
+    buffer[sol::meta_method::index] = [](const FloatBuffer& self, size_t index) {
+        return self.get(index - 1);
+    };
+    buffer[sol::meta_method::new_index] = [](FloatBuffer& self, size_t index, float value) {
+        self.set(index - 1, value);
+    };
+    buffer[sol::meta_method::length] = &FloatBuffer::size;
+    buffer[sol::meta_method::to_string] = [](const FloatBuffer& self) {
+        return std::format("FloatBuffer {{ size: {} }}", self.size()); 
+    };
+}
+
 template <> 
 void Lua::registerType<Event>()
 {
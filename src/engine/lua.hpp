@@ -1,9 +1,20 @@
 #pragma once
 
 #include "../resource/lua_source.hpp"
+#include "../resource/resource_manager.hpp"
 #include "event.hpp"
 #include "sprite.hpp"
+#include "collision.hpp"
+#include "ecs.hpp"
+#include "kinematics.hpp"
+#include "camera.hpp"
 #include "keycodes.hpp"
+#include "timestep.hpp"
+#include "float_buffer.hpp"
+#include "lua_profiler.hpp"
+#include <optional>
+#include <span>
+#include <string>
 #include <vector>
 #include <unordered_map>
 #include <sol/forward.hpp>
@@ -11,9 +22,13 @@
 
 namespace Engine {
 
+class Window;
+
 class Lua {
 public:
-    Lua(SpriteManager& sprite_manager);
+    Lua(SpriteManager& sprite_manager, CollisionWorld& collision, EntityRegistry& registry, ResourceManager& resource_manager, Camera& camera, FixedTimestep& timestep, Window& window);
+    // Script components hold Lua values, they're dropped here while the state still exists
+    ~Lua();
 
     template <typename T>
     void registerType();
@@ -23,21 +38,40 @@ public:
 
     void runEntryPoint(const LuaSource& source);
     
+    // Also applies profiler start/stop requests since it runs once per frame on the Lua thread
     void gc();
 
+    LuaProfiler& getProfiler();
+
     void setKeyState(KeyCode keycode, bool state);
     
     template <typename... Args>
     void fireBuiltinEvent(const std::string& name, Args&&... args);
+
+    // Fires OnCollisions once with every pair that started or stopped touching, skipped
+    // when there's nothing to report
+    void fireCollisionEvents(std::span<const CollisionEvent> events);
  
 private:
     static void panic(std::optional<std::string> maybe_message);
 
+    std::optional<ComponentId> findComponent(const std::string& name) const;
+    sol::object getComponent(sol::this_state state, ComponentId id, Entity entity);
+
+    SpriteManager& sprite_manager;
+    EntityRegistry& registry;
+    FixedTimestep& timestep;
+    // Components scripts can name, the ones defined from Lua store any Lua value
+    std::unordered_map<std::string, ComponentId> script_components;
+    // Declared before the state so it's still around for hook calls while the state closes
+    LuaProfiler profiler;
     sol::state lua;
     std::unordered_map<std::string, Event> builtin_events = {
         { "OnFrameStep", Event() },
+        { "OnFixedStep", Event() },
         { "OnKeyPressed", Event() },
         { "OnKeyReleased", Event() },
+        { "OnCollisions", Event() },
     };
     std::unordered_map<KeyCode, bool> key_state = {
         { KeyCode::Up, false },
@@ -70,6 +104,11 @@ void Lua::fireBuiltinEvent(const std::string& name, Args&&... args)
 template <> void Lua::registerType<glm::vec2>();
 template <> void Lua::registerType<glm::vec3>();
 template <> void Lua::registerType<Sprite>();
+template <> void Lua::registerType<SpriteBatch>();
+template <> void Lua::registerType<AtlasRegion>();
+template <> void Lua::registerType<Camera>();
+template <> void Lua::registerType<Kinematics>();
+template <> void Lua::registerType<FloatBuffer>();
 template <> void Lua::registerType<Event>();
 template <> void Lua::registerType<EventConnection>();
 
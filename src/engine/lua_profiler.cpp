@@ -0,0 +1,210 @@
+#include <pch.hpp>
+
+#include "lua_profiler.hpp"
+#include <algorithm>
+#include <fstream>
+
+namespace Engine {
+
+// Hooks are plain C functions without userdata, only one profiler can be attached at a time
+static LuaProfiler* hooked_profiler = nullptr;
+
+std::string trimScriptSource(std::string_view source)
+{
+    size_t folder_pos = source.find("resources/");
+    if (folder_pos != std::string_view::npos) {
+        return std::string(source.substr(folder_pos));
+    }
+    return std::string(source);
+}
+
+// Functions are identified by where they're defined so every sample of the same function
+// lands in the same bucket no matter which line was running
+
+static std::string frameName(const lua_Debug& debug)
+{
+    if (debug.what != nullptr && std::string_view(debug.what) == "C") {
+        return std::format("[C] {}", debug.name != nullptr ? debug.name : "?");
+    }
+    std::string source = trimScriptSource(debug.short_src);
+    if (debug.what != nullptr && std::string_view(debug.what) == "main") {
+        return std::format("{} (main)", source);
+    }
+    if (debug.name != nullptr) {
+        return std::format("{}:{} ({})", source, debug.linedefined, debug.name);
+    }
+    return std::format("{}:{}", source, debug.linedefined);
+}
+
+LuaProfiler::~LuaProfiler()
+{
+    if (hooked_profiler == this) {
+        hooked_profiler = nullptr;
+    }
+}
+
+void LuaProfiler::start()
+{
+    requested = true;
+}
+
+void LuaProfiler::stop()
+{
+    requested = false;
+}
+
+void LuaProfiler::reset()
+{
+    std::lock_guard lock(mutex);
+    sample_count = 0;
+    functions.clear();
+    lines.clear();
+    stacks.clear();
+}
+
+bool LuaProfiler::isRunning() const
+{
+    return requested;
+}
+
+void LuaProfiler::setSampleInterval(int instructions)
+{
+    sample_interval = std::max(instructions, 1);
+}
+
+void LuaProfiler::update(lua_State* state)
+{
+    const bool wanted = requested;
+    const int interval = sample_interval;
+    if (wanted == hooked && (!hooked || interval == hooked_interval)) {
+        return;
+    }
+
+    if (wanted) {
+        if (hooked_profiler != nullptr && hooked_profiler != this) {
+            Log::warn(Log::Category::Lua, "Another Lua profiler is already attached, not starting");
+            requested = false;
+            return;
+        }
+        lua_sethook(state, &LuaProfiler::hook, LUA_MASKCOUNT, interval);
+        hooked_profiler = this;
+        hooked_interval = interval;
+        Log::info(Log::Category::Lua, "Lua profiler started, sampling every {} instructions", interval);
+    } else {
+        lua_sethook(state, nullptr, 0, 0);
+        hooked_profiler = nullptr;
+        Log::info(Log::Category::Lua, "Lua profiler stopped after {} samples", getSampleCount());
+    }
+    hooked = wanted;
+}
+
+void LuaProfiler::hook(lua_State* state, lua_Debug* debug)
+{
+    if (debug->event == LUA_HOOKCOUNT && hooked_profiler != nullptr) {
+        hooked_profiler->sample(state);
+    }
+}
+
+void LuaProfiler::sample(lua_State* state)
+{
+    // Level 0 is the function that was running when the hook fired
+    std::vector<std::string> frames;
+    std::string leaf_line;
+    lua_Debug debug;
+    for (int level = 0; level < MAX_STACK_DEPTH && lua_getstack(state, level, &debug); level++) {
+        lua_getinfo(state, "Sln", &debug);
+        if (level == 0) {
+            leaf_line = std::format("{}:{}", trimScriptSource(debug.short_src), debug.currentline);
+        }
+        frames.push_back(frameName(debug));
+    }
+    if (frames.empty()) {
+        return;
+    }
+
+    std::string stack;
+    for (auto frame = frames.rbegin(); frame != frames.rend(); frame++) {
+        if (!stack.empty()) {
+            stack += ';';
+        }
+        stack += *frame;
+    }
+
+    std::lock_guard lock(mutex);
+    sample_count++;
+    stacks[stack]++;
+    lines[leaf_line]++;
+    for (size_t i = 0; i < frames.size(); i++) {
+        // Recursive functions only count once towards their total per sample
+        if (std::find(frames.begin(), frames.begin() + i, frames[i]) != frames.begin() + i) {
+            continue;
+        }
+        FunctionStats& stats = functions[frames[i]];
+        if (stats.name.empty()) {
+            stats.name = frames[i];
+        }
+        stats.total_samples++;
+        if (i == 0) {
+            stats.self_samples++;
+        }
+    }
+}
+
+size_t LuaProfiler::getSampleCount() const
+{
+    std::lock_guard lock(mutex);
+    return sample_count;
+}
+
+std::vector<LuaProfiler::FunctionStats> LuaProfiler::getFunctionStats() const
+{
+    std::vector<FunctionStats> result;
+    {
+        std::lock_guard lock(mutex);
+        result.reserve(functions.size());
+        for (const auto& [name, stats] : functions) {
+            result.push_back(stats);
+        }
+    }
+    std::sort(result.begin(), result.end(), [](const FunctionStats& lhs, const FunctionStats& rhs) {
+        return lhs.self_samples > rhs.self_samples;
+    });
+    return result;
+}
+
+std::vector<std::pair<std::string, size_t>> LuaProfiler::getLineStats() const
+{
+    std::vector<std::pair<std::string, size_t>> result;
+    {
+        std::lock_guard lock(mutex);
+        result.assign(lines.begin(), lines.end());
+    }
+    std::sort(result.begin(), result.end(), [](const auto& lhs, const auto& rhs) {
+        return lhs.second > rhs.second;
+    });
+    return result;
+}
+
+std::string LuaProfiler::getFoldedStacks() const
+{
+    std::lock_guard lock(mutex);
+    std::string folded;
+    for (const auto& [stack, count] : stacks) {
+        folded += std::format("{} {}\n", stack, count);
+    }
+    return folded;
+}
+
+bool LuaProfiler::exportFoldedStacks(const std::filesystem::path& path) const
+{
+    std::ofstream file(path);
+    if (!file) {
+        Log::error(Log::Category::Lua, "Failed to open {} for writing the Lua profile", path.string());
+        return false;
+    }
+    file << getFoldedStacks();
+    Log::info(Log::Category::Lua, "Wrote Lua profile with {} samples to {}", getSampleCount(), path.string());
+    return true;
+}
+
+} // namespace Engine
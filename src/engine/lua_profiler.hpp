@@ -0,0 +1,77 @@
+#pragma once
+
+#include "../constructors.hpp"
+#include <atomic>
+#include <cstddef>
+#include <filesystem>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+struct lua_State;
+struct lua_Debug;
+
+namespace Engine {
+
+// Strips everything before the resources folder from a chunk name to keep output short
+std::string trimScriptSource(std::string_view source);
+
+// Sampling profiler for scripts. A count hook fires every N VM instructions and records
+// the whole Lua call stack, which gets aggregated per function and per unique stack.
+// Start and stop are only requests, they are applied from the Lua thread on update.
+
+class LuaProfiler {
+public:
+    constexpr static int DEFAULT_SAMPLE_INTERVAL = 1000;
+    constexpr static int MAX_STACK_DEPTH = 64;
+
+    struct FunctionStats {
+        std::string name;
+        size_t self_samples = 0;
+        size_t total_samples = 0;
+    };
+
+    LuaProfiler() = default;
+    ~LuaProfiler();
+    DELETE_COPY(LuaProfiler);
+    DELETE_MOVE(LuaProfiler);
+
+    void start();
+    void stop();
+    void reset();
+    bool isRunning() const;
+    void setSampleInterval(int instructions);
+
+    // Must be called from the thread running the Lua state
+    void update(lua_State* state);
+
+    size_t getSampleCount() const;
+    std::vector<FunctionStats> getFunctionStats() const;
+    // Self samples per source:line of the running function
+    std::vector<std::pair<std::string, size_t>> getLineStats() const;
+
+    // Folded stacks, one "outer;inner;leaf count" line per unique stack, the format
+    // flamegraph.pl and speedscope read
+    std::string getFoldedStacks() const;
+    bool exportFoldedStacks(const std::filesystem::path& path) const;
+
+private:
+    static void hook(lua_State* state, lua_Debug* debug);
+    void sample(lua_State* state);
+
+    std::atomic<bool> requested = false;
+    std::atomic<int> sample_interval = DEFAULT_SAMPLE_INTERVAL;
+    bool hooked = false;
+    int hooked_interval = 0;
+
+    mutable std::mutex mutex;
+    size_t sample_count = 0;
+    std::unordered_map<std::string, FunctionStats> functions;
+    std::unordered_map<std::string, size_t> lines;
+    std::unordered_map<std::string, size_t> stacks;
+};
+
+} // namespace Engine
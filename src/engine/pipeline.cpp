@@ -0,0 +1,88 @@
+#include <pch.hpp>
+
+#include "pipeline.hpp"
+#include "profiler.hpp"
+#include "../gfx/window.hpp"
+
+namespace Engine {
+
+FramePipeline::FramePipeline(Window& window, RenderStage render_stage)
+    : window(window), render_stage(std::move(render_stage))
+{
+    // The GL context can only be current on one thread at a time
+    window.releaseContext();
+    thread = std::thread(&FramePipeline::renderThread, this);
+}
+
+FramePipeline::~FramePipeline()
+{
+    {
+        std::unique_lock lock(mutex);
+        condition.wait(lock, [this]() { return !pending.has_value(); });
+        running = false;
+    }
+    condition.notify_all();
+    thread.join();
+
+    window.acquireContext();
+}
+
+RenderSnapshot& FramePipeline::beginFrame()
+{
+    PROFILE_SCOPE("FramePipeline::beginFrame");
+    std::unique_lock lock(mutex);
+    condition.wait(lock, [this]() {
+        return pending != write_index && in_flight != write_index;
+    });
+
+    RenderSnapshot& snapshot = snapshots[write_index];
+    snapshot.sprite_instances = nullptr;
+    snapshot.atlas_update = nullptr;
+    snapshot.ui_input.events.clear();
+    return snapshot;
+}
+
+void FramePipeline::submitFrame()
+{
+    PROFILE_SCOPE("FramePipeline::submitFrame");
+    {
+        std::unique_lock lock(mutex);
+        condition.wait(lock, [this]() { return !pending.has_value(); });
+        pending = write_index;
+        write_index = (write_index + 1) % snapshots.size();
+    }
+    condition.notify_all();
+}
+
+void FramePipeline::renderThread()
+{
+    window.acquireContext();
+    GLOBAL_PROFILER.setThreadName("Render");
+
+    while (true) {
+        size_t index;
+        {
+            std::unique_lock lock(mutex);
+            condition.wait(lock, [this]() { return pending.has_value() || !running; });
+            if (!pending.has_value()) {
+                break;
+            }
+            index = *pending;
+            in_flight = index;
+            pending = std::nullopt;
+        }
+        condition.notify_all();
+
+        render_stage(snapshots[index]);
+
+        {
+            std::unique_lock lock(mutex);
+            in_flight = std::nullopt;
+        }
+        condition.notify_all();
+    }
+
+    window.releaseContext();
+}
+
+} // namespace Engine
@@ -0,0 +1,67 @@
+#pragma once
+
+#include "sprite.hpp"
+#include "ui_input.hpp"
+#include "../constructors.hpp"
+#include <array>
+#include <condition_variable>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <thread>
+#include <vector>
+#include <glm/glm.hpp>
+
+namespace Engine {
+
+class Window;
+
+// Everything the render thread needs to draw a frame. Once submitted the simulation
+// thread doesn't touch it again until the render thread hands it back.
+
+struct RenderSnapshot {
+    std::shared_ptr<const std::vector<SpriteInstanceData>> sprite_instances;
+    // Has to be uploaded even when the sprites didn't change
+    std::shared_ptr<const AtlasUpdate> atlas_update;
+    glm::mat4 projection = glm::mat4(1.f);
+    glm::vec2 viewport = glm::vec2(0.f, 0.f);
+    float delta_time = 0.f;
+    // SDL can only be asked on the main thread, ImGui wants its input where it renders
+    UiInput ui_input;
+};
+
+// Runs the render stage on its own thread so that building frame N+1 on the simulation
+// thread overlaps with GL submission of frame N. Snapshots are double buffered, the
+// simulation thread only blocks when it gets more than a frame ahead.
+
+class FramePipeline {
+public:
+    using RenderStage = std::function<void(const RenderSnapshot&)>;
+
+    FramePipeline(Window& window, RenderStage render_stage);
+    ~FramePipeline();
+    DELETE_COPY(FramePipeline);
+    DELETE_MOVE(FramePipeline);
+
+    RenderSnapshot& beginFrame();
+    void submitFrame();
+
+private:
+    void renderThread();
+
+    Window& window;
+    RenderStage render_stage;
+
+    std::array<RenderSnapshot, 2> snapshots;
+    size_t write_index = 0;
+    std::optional<size_t> pending;
+    std::optional<size_t> in_flight;
+    bool running = true;
+
+    std::mutex mutex;
+    std::condition_variable condition;
+    std::thread thread;
+};
+
+} // namespace Engine
@@ -0,0 +1,207 @@
+#include <pch.hpp>
+
+#include "profiler.hpp"
+#include <algorithm>
+#include <fstream>
+#include <map>
+
+namespace Engine {
+
+Profiler GLOBAL_PROFILER;
+
+std::vector<ProfileZoneTotal> summarizeFrame(const ProfileFrame& frame)
+{
+    std::vector<ProfileZoneTotal> totals;
+    std::map<std::pair<uint32_t, std::string_view>, size_t> lookup;
+    for (const auto& zone : frame.zones) {
+        auto [it, inserted] = lookup.try_emplace({ zone.thread, zone.name }, totals.size());
+        if (inserted) {
+            totals.push_back({ zone.name, zone.thread, zone.depth, zone.start });
+        }
+        ProfileZoneTotal& total = totals[it->second];
+        total.depth = std::min(total.depth, zone.depth);
+        total.first_start = std::min(total.first_start, zone.start);
+        total.duration += zone.end - zone.start;
+        total.calls++;
+    }
+    std::sort(totals.begin(), totals.end(), [](const ProfileZoneTotal& lhs, const ProfileZoneTotal& rhs) {
+        return lhs.thread != rhs.thread ? lhs.thread < rhs.thread : lhs.first_start < rhs.first_start;
+    });
+    return totals;
+}
+
+bool ProfileBuffer::push(const ProfileEvent& event)
+{
+    const size_t index = head.load(std::memory_order_relaxed);
+    if (index - tail.load(std::memory_order_acquire) >= CAPACITY) {
+        return false;
+    }
+    events[index % CAPACITY] = event;
+    head.store(index + 1, std::memory_order_release);
+    return true;
+}
+
+Profiler::Profiler()
+    : epoch(std::chrono::steady_clock::now())
+{
+
+}
+
+void Profiler::setEnabled(bool enable)
+{
+    enabled.store(enable, std::memory_order_relaxed);
+}
+
+uint64_t Profiler::now() const
+{
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - epoch).count();
+}
+
+void Profiler::setThreadName(const std::string& name)
+{
+    ThreadState& state = getThreadState();
+    std::lock_guard lock(threads_mutex);
+    state.name = name;
+}
+
+void Profiler::record(const char* name, uint64_t start, uint64_t end, uint32_t depth)
+{
+    if (!getThreadState().buffer.push({ name, start, end, depth })) {
+        dropped.fetch_add(1, std::memory_order_relaxed);
+    }
+}
+
+// Thread states are never freed so the collector can still drain a thread's last events
+// after it exits, there's only ever a handful of threads anyway
+
+Profiler::ThreadState& Profiler::getThreadState()
+{
+    thread_local ThreadState* state = nullptr;
+    if (state == nullptr) {
+        std::lock_guard lock(threads_mutex);
+        auto& created = threads.emplace_back(std::make_unique<ThreadState>());
+        created->id = static_cast<uint32_t>(threads.size() - 1);
+        created->name = std::format("Thread {}", created->id);
+        state = created.get();
+    }
+    return *state;
+}
+
+void Profiler::endFrame()
+{
+    const uint64_t frame_end = now();
+    if (!isEnabled()) {
+        frame_start = frame_end;
+        return;
+    }
+
+    ProfileFrame frame { frame_index++, frame_start, frame_end, {} };
+    {
+        std::lock_guard lock(threads_mutex);
+        for (auto& thread : threads) {
+            thread->buffer.drain([&](const ProfileEvent& event) {
+                frame.zones.push_back({ event.name, event.start, event.end, event.depth, thread->id });
+            });
+        }
+    }
+    frame_start = frame_end;
+
+    std::lock_guard lock(frames_mutex);
+    frames.push_back(std::move(frame));
+    while (frames.size() > FRAME_HISTORY) {
+        frames.pop_front();
+    }
+}
+
+std::optional<ProfileFrame> Profiler::getLastFrame() const
+{
+    std::lock_guard lock(frames_mutex);
+    if (frames.empty()) {
+        return std::nullopt;
+    }
+    return frames.back();
+}
+
+std::vector<ProfileFrame> Profiler::getFrames() const
+{
+    std::lock_guard lock(frames_mutex);
+    return std::vector<ProfileFrame>(frames.begin(), frames.end());
+}
+
+std::vector<std::string> Profiler::getThreadNames() const
+{
+    std::lock_guard lock(threads_mutex);
+    std::vector<std::string> names;
+    for (const auto& thread : threads) {
+        names.push_back(thread->name);
+    }
+    return names;
+}
+
+size_t Profiler::getDroppedCount() const
+{
+    return dropped.load(std::memory_order_relaxed);
+}
+
+std::string escapeJson(std::string_view text)
+{
+    std::string escaped;
+    for (char c : text) {
+        if (c == '"' || c == '\\') {
+            escaped += '\\';
+            escaped += c;
+        } else if (static_cast<unsigned char>(c) < 0x20) {
+            escaped += std::format("\\u{:04x}", static_cast<int>(c));
+        } else {
+            escaped += c;
+        }
+    }
+    return escaped;
+}
+
+// Complete ("X") events in microseconds, loads in chrome://tracing, Perfetto and speedscope
+
+bool Profiler::exportChromeTrace(const std::filesystem::path& path) const
+{
+    std::ofstream file(path);
+    if (!file) {
+        Log::error("Failed to open {} for writing the trace", path.string());
+        return false;
+    }
+
+    const auto thread_names = getThreadNames();
+    const auto history = getFrames();
+
+    file << "{\"traceEvents\":[\n";
+    bool first = true;
+    auto separator = [&]() {
+        if (!first) {
+            file << ",\n";
+        }
+        first = false;
+    };
+
+    for (size_t i = 0; i < thread_names.size(); i++) {
+        separator();
+        file << std::format(
+            R"({{"name":"thread_name","ph":"M","pid":0,"tid":{},"args":{{"name":"{}"}}}})",
+            i, escapeJson(thread_names[i])
+        );
+    }
+
+    for (const auto& frame : history) {
+        for (const auto& zone : frame.zones) {
+            separator();
+            file << std::format(
+                R"({{"name":"{}","ph":"X","pid":0,"tid":{},"ts":{:.3f},"dur":{:.3f},"args":{{"frame":{}}}}})",
+                escapeJson(zone.name), zone.thread, zone.start / 1000.0, (zone.end - zone.start) / 1000.0, frame.index
+            );
+        }
+    }
+    file << "\n]}\n";
+
+    Log::info("Wrote trace of {} frames to {}", history.size(), path.string());
+    return true;
+}
+
+} // namespace Engine
@@ -0,0 +1,195 @@
+#pragma once
+
+#include "../constructors.hpp"
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <filesystem>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// Set to 0 to compile every PROFILE_SCOPE out of the build
+#if !defined(GAME_ENABLE_PROFILER)
+#define GAME_ENABLE_PROFILER 1
+#endif
+
+namespace Engine {
+
+// Names have to outlive the profiler, in practice they're always string literals.
+// Times are nanoseconds since the profiler was created.
+
+struct ProfileEvent {
+    const char* name;
+    uint64_t start;
+    uint64_t end;
+    uint32_t depth;
+};
+
+struct ProfileZone {
+    const char* name;
+    uint64_t start;
+    uint64_t end;
+    uint32_t depth;
+    uint32_t thread;
+};
+
+struct ProfileFrame {
+    uint64_t index;
+    uint64_t start;
+    uint64_t end;
+    std::vector<ProfileZone> zones;
+};
+
+struct ProfileZoneTotal {
+    const char* name;
+    uint32_t thread;
+    uint32_t depth;
+    uint64_t first_start;
+    uint64_t duration = 0;
+    size_t calls = 0;
+};
+
+// Zones of one frame summed up per thread and name, in the order they first ran
+std::vector<ProfileZoneTotal> summarizeFrame(const ProfileFrame& frame);
+
+// For strings written into the JSON reports, without the surrounding quotes
+std::string escapeJson(std::string_view text);
+
+// Single producer, single consumer ring. The owning thread pushes finished scopes and the
+// collector drains them, when it's full new events get dropped rather than blocking.
+
+class ProfileBuffer {
+public:
+    constexpr static size_t CAPACITY = 8192;
+
+    bool push(const ProfileEvent& event);
+
+    template <typename Function>
+    void drain(Function&& function);
+
+private:
+    std::array<ProfileEvent, CAPACITY> events;
+    alignas(64) std::atomic<size_t> head = 0;
+    alignas(64) std::atomic<size_t> tail = 0;
+};
+
+template <typename Function>
+void ProfileBuffer::drain(Function&& function)
+{
+    const size_t first = tail.load(std::memory_order_relaxed);
+    const size_t last = head.load(std::memory_order_acquire);
+    for (size_t i = first; i < last; i++) {
+        function(events[i % CAPACITY]);
+    }
+    tail.store(last, std::memory_order_release);
+}
+
+class Profiler {
+public:
+    constexpr static size_t FRAME_HISTORY = 300;
+
+    Profiler();
+    DELETE_COPY(Profiler);
+    DELETE_MOVE(Profiler);
+
+    void setEnabled(bool enable);
+    bool isEnabled() const
+    {
+        return enabled.load(std::memory_order_relaxed);
+    }
+
+    uint64_t now() const;
+
+    // Names the calling thread in the debug view and trace exports
+    void setThreadName(const std::string& name);
+
+    // Called by ProfileScope on whichever thread the scope ran on
+    void record(const char* name, uint64_t start, uint64_t end, uint32_t depth);
+
+    // Collects everything recorded since the last call into a new frame. Threads that
+    // run behind the simulation, like the render thread, show up one frame late.
+    void endFrame();
+
+    std::optional<ProfileFrame> getLastFrame() const;
+    std::vector<ProfileFrame> getFrames() const;
+    std::vector<std::string> getThreadNames() const;
+    size_t getDroppedCount() const;
+
+    bool exportChromeTrace(const std::filesystem::path& path) const;
+
+private:
+    struct ThreadState {
+        ProfileBuffer buffer;
+        std::string name;
+        uint32_t id;
+    };
+
+    ThreadState& getThreadState();
+
+    std::atomic<bool> enabled = false;
+    std::chrono::steady_clock::time_point epoch;
+    std::atomic<size_t> dropped = 0;
+
+    mutable std::mutex threads_mutex;
+    std::vector<std::unique_ptr<ThreadState>> threads;
+
+    mutable std::mutex frames_mutex;
+    std::deque<ProfileFrame> frames;
+    uint64_t frame_index = 0;
+    uint64_t frame_start = 0;
+};
+
+extern Profiler GLOBAL_PROFILER;
+
+// Times the enclosing scope. When the profiler is disabled this is a relaxed load and a
+// branch on the way in and out.
+
+class ProfileScope {
+public:
+    explicit ProfileScope(const char* name)
+        : name(name)
+    {
+        if (GLOBAL_PROFILER.isEnabled()) {
+            active = true;
+            depth = current_depth++;
+            start = GLOBAL_PROFILER.now();
+        }
+    }
+
+    ~ProfileScope()
+    {
+        if (active) {
+            current_depth--;
+            GLOBAL_PROFILER.record(name, start, GLOBAL_PROFILER.now(), depth);
+        }
+    }
+
+    DELETE_COPY(ProfileScope);
+    DELETE_MOVE(ProfileScope);
+
+private:
+    static inline thread_local uint32_t current_depth = 0;
+
+    const char* name;
+    uint64_t start = 0;
+    uint32_t depth = 0;
+    bool active = false;
+};
+
+} // namespace Engine
+
+#define PROFILE_CONCAT_INNER(a, b) a##b
+#define PROFILE_CONCAT(a, b) PROFILE_CONCAT_INNER(a, b)
+
+#if GAME_ENABLE_PROFILER
+#define PROFILE_SCOPE(name) ::Engine::ProfileScope PROFILE_CONCAT(profile_scope_, __LINE__)(name)
+#else
+#define PROFILE_SCOPE(name) ((void)0)
+#endif
@@ -0,0 +1,46 @@
+#pragma once
+
+#include "../platform.hpp"
+
+// SSE2 is part of the x86-64 baseline so it is always on there. AVX2 code has to be
+// compiled per function with a target attribute and only called after checking the CPU.
+
+#if defined(GAME_ARCH_X86_64)
+#define GAME_SIMD_SSE2
+#include <emmintrin.h>
+#include <xmmintrin.h>
+#if defined(GAME_COMPILER_GCC) || defined(GAME_COMPILER_CLANG)
+#define GAME_SIMD_AVX2
+#define GAME_TARGET_AVX2 __attribute__((target("avx2")))
+#include <immintrin.h>
+#endif
+#endif
+
+namespace Engine {
+
+#if defined(GAME_SIMD_SSE2)
+
+inline float horizontalMin(__m128 value)
+{
+    value = _mm_min_ps(value, _mm_shuffle_ps(value, value, _MM_SHUFFLE(2, 3, 0, 1)));
+    value = _mm_min_ps(value, _mm_shuffle_ps(value, value, _MM_SHUFFLE(1, 0, 3, 2)));
+    return _mm_cvtss_f32(value);
+}
+
+inline float horizontalMax(__m128 value)
+{
+    value = _mm_max_ps(value, _mm_shuffle_ps(value, value, _MM_SHUFFLE(2, 3, 0, 1)));
+    value = _mm_max_ps(value, _mm_shuffle_ps(value, value, _MM_SHUFFLE(1, 0, 3, 2)));
+    return _mm_cvtss_f32(value);
+}
+
+inline float horizontalSum(__m128 value)
+{
+    value = _mm_add_ps(value, _mm_shuffle_ps(value, value, _MM_SHUFFLE(2, 3, 0, 1)));
+    value = _mm_add_ps(value, _mm_shuffle_ps(value, value, _MM_SHUFFLE(1, 0, 3, 2)));
+    return _mm_cvtss_f32(value);
+}
+
+#endif
+
+} // namespace Engine
@@ -0,0 +1,178 @@
+#include <pch.hpp>
+
+#include "spatial_grid.hpp"
+#include <algorithm>
+#include <cmath>
+
+namespace Engine {
+
+bool SpriteBounds::overlaps(const SpriteBounds& other) const
+{
+    return min.x <= other.max.x && max.x >= other.min.x && min.y <= other.max.y && max.y >= other.min.y;
+}
+
+SpatialGrid::SpatialGrid(float cell_size)
+    : cell_size(cell_size)
+{
+
+}
+
+// Positions and query bounds come straight from scripts, infinities end up in the outermost
+// cells and NaN in the one at the origin
+
+glm::ivec2 SpatialGrid::cellOf(glm::vec2 position) const
+{
+    const auto toCell = [this](float value) {
+        const float cell = std::floor(value / cell_size);
+        return std::isnan(cell) ? 0 : static_cast<int>(std::clamp(cell, -MAX_CELL, MAX_CELL));
+    };
+    return glm::ivec2(toCell(position.x), toCell(position.y));
+}
+
+SpatialGrid::CellKey SpatialGrid::keyOf(glm::ivec2 cell)
+{
+    return (static_cast<CellKey>(static_cast<uint32_t>(cell.x)) << 32) | static_cast<uint32_t>(cell.y);
+}
+
+void SpatialGrid::update(SpriteId id, glm::vec2 position, float half_size)
+{
+    const size_t sprite_slot = spriteSlot(id);
+    if (sprite_slot >= entries.size()) {
+        entries.resize(sprite_slot + 1);
+    }
+    Entry& entry = entries[sprite_slot];
+    const CellKey cell = keyOf(cellOf(position));
+    max_half_size = std::max(max_half_size, half_size);
+
+    // Moving within a cell is the common case and only touches the entry
+    if (entry.slot != NOT_PRESENT && entry.id == id && entry.cell == cell) {
+        entry.position = position;
+        entry.half_size = half_size;
+        return;
+    }
+
+    if (entry.slot != NOT_PRESENT) {
+        removeFromCell(entry);
+    } else {
+        count++;
+    }
+
+    std::vector<SpriteId>& ids = cells[cell];
+    entry.id = id;
+    entry.cell = cell;
+    entry.position = position;
+    entry.half_size = half_size;
+    entry.slot = static_cast<uint32_t>(ids.size());
+    ids.push_back(id);
+}
+
+void SpatialGrid::remove(SpriteId id)
+{
+    if (!contains(id)) {
+        return;
+    }
+    Entry& entry = entries[spriteSlot(id)];
+    removeFromCell(entry);
+    entry.slot = NOT_PRESENT;
+    count--;
+}
+
+// Swaps the last id of the cell into the hole, empty cells are dropped so memory follows
+// where sprites are rather than everywhere they've been
+
+void SpatialGrid::removeFromCell(const Entry& entry)
+{
+    const auto cell = cells.find(entry.cell);
+    std::vector<SpriteId>& ids = cell->second;
+    const SpriteId moved = ids.back();
+    ids[entry.slot] = moved;
+    entries[spriteSlot(moved)].slot = entry.slot;
+    ids.pop_back();
+    if (ids.empty()) {
+        cells.erase(cell);
+    }
+}
+
+bool SpatialGrid::contains(SpriteId id) const
+{
+    const size_t sprite_slot = spriteSlot(id);
+    return sprite_slot < entries.size() && entries[sprite_slot].slot != NOT_PRESENT && entries[sprite_slot].id == id;
+}
+
+size_t SpatialGrid::size() const
+{
+    return count;
+}
+
+// Visits the cells the query could reach, or every occupied cell when that's fewer, and
+// keeps the sprites that pass the exact test
+
+template <typename Filter>
+void SpatialGrid::forEachCandidate(const SpriteBounds& bounds, std::vector<SpriteId>& out, Filter filter) const
+{
+    if (count == 0) {
+        return;
+    }
+
+    const glm::ivec2 first = cellOf(bounds.min - max_half_size);
+    const glm::ivec2 last = cellOf(bounds.max + max_half_size);
+    const double covered = (static_cast<double>(last.x) - first.x + 1) * (static_cast<double>(last.y) - first.y + 1);
+
+    const auto visit = [&](const std::vector<SpriteId>& ids) {
+        for (SpriteId id : ids) {
+            if (filter(entries[spriteSlot(id)])) {
+                out.push_back(id);
+            }
+        }
+    };
+
+    if (covered > static_cast<double>(cells.size())) {
+        for (const auto& [key, ids] : cells) {
+            visit(ids);
+        }
+        return;
+    }
+
+    for (int y = first.y; y <= last.y; y++) {
+        for (int x = first.x; x <= last.x; x++) {
+            const auto cell = cells.find(keyOf(glm::ivec2(x, y)));
+            if (cell != cells.end()) {
+                visit(cell->second);
+            }
+        }
+    }
+}
+
+void SpatialGrid::query(const SpriteBounds& bounds, std::vector<SpriteId>& out) const
+{
+    forEachCandidate(bounds, out, [&](const Entry& entry) {
+        return entry.position.x + entry.half_size >= bounds.min.x && entry.position.x - entry.half_size <= bounds.max.x
+            && entry.position.y + entry.half_size >= bounds.min.y && entry.position.y - entry.half_size <= bounds.max.y;
+    });
+}
+
+void SpatialGrid::query(glm::vec2 center, float radius, std::vector<SpriteId>& out) const
+{
+    const SpriteBounds bounds {
+        .min = center - radius,
+        .max = center + radius,
+    };
+    forEachCandidate(bounds, out, [&](const Entry& entry) {
+        // Distance from the centre to the closest point of the sprite's box
+        const glm::vec2 closest = glm::clamp(center, entry.position - entry.half_size, entry.position + entry.half_size);
+        const glm::vec2 offset = center - closest;
+        return offset.x * offset.x + offset.y * offset.y <= radius * radius;
+    });
+}
+
+float SpatialGrid::getCellSize() const
+{
+    return cell_size;
+}
+
+size_t SpatialGrid::getCellCount() const
+{
+    return cells.size();
+}
+
+} // namespace Engine
@@ -0,0 +1,93 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+#include <glm/glm.hpp>
+
+namespace Engine {
+
+// The low 32 bits are the slot the sprite lives in, the bits above count how often that
+// slot has been reused so a handle to a destroyed sprite never matches the next one. The
+// count wraps early enough for ids to stay exact as Lua numbers.
+using SpriteId = size_t;
+
+constexpr size_t SPRITE_GENERATION_BITS = 20;
+
+inline size_t spriteSlot(SpriteId id)
+{
+    return static_cast<uint32_t>(id);
+}
+
+inline SpriteId nextSpriteGeneration(SpriteId id)
+{
+    const size_t generation = ((id >> 32) + 1) & ((size_t(1) << SPRITE_GENERATION_BITS) - 1);
+    return (generation << 32) | spriteSlot(id);
+}
+
+// Axis aligned box in world space
+struct SpriteBounds {
+    glm::vec2 min;
+    glm::vec2 max;
+
+    bool overlaps(const SpriteBounds& other) const;
+};
+
+// Uniform grid over sprite positions for range queries. Each sprite lives in the one cell
+// its centre falls in and queries grow by the largest half size seen so far, so moving a
+// sprite is at most a removal from one cell and an insert into another. Cells are hashed
+// by coordinate, the world has no bounds and empty space costs nothing.
+
+class SpatialGrid {
+public:
+    constexpr static float DEFAULT_CELL_SIZE = 256.f;
+
+    explicit SpatialGrid(float cell_size = DEFAULT_CELL_SIZE);
+
+    // Inserts the sprite or moves it if it's already in the grid
+    void update(SpriteId id, glm::vec2 position, float half_size);
+    void remove(SpriteId id);
+    bool contains(SpriteId id) const;
+    size_t size() const;
+
+    // Appends every sprite whose box overlaps the query, in no particular order
+    void query(const SpriteBounds& bounds, std::vector<SpriteId>& out) const;
+    void query(glm::vec2 center, float radius, std::vector<SpriteId>& out) const;
+
+    float getCellSize() const;
+    size_t getCellCount() const;
+
+private:
+    using CellKey = uint64_t;
+
+    constexpr static uint32_t NOT_PRESENT = UINT32_MAX;
+    // Cell coordinates are clamped to this so far off positions and unbounded queries stay
+    // well inside int, with room to step one past the last cell
+    constexpr static float MAX_CELL = 1 << 30;
+
+    struct Entry {
+        SpriteId id = 0;
+        CellKey cell = 0;
+        glm::vec2 position = glm::vec2(0.f, 0.f);
+        float half_size = 0.f;
+        // Index into the cell's id list, NOT_PRESENT when the sprite isn't in the grid
+        uint32_t slot = NOT_PRESENT;
+    };
+
+    glm::ivec2 cellOf(glm::vec2 position) const;
+    static CellKey keyOf(glm::ivec2 cell);
+    void removeFromCell(const Entry& entry);
+
+    template <typename Filter>
+    void forEachCandidate(const SpriteBounds& bounds, std::vector<SpriteId>& out, Filter filter) const;
+
+    float cell_size;
+    std::unordered_map<CellKey, std::vector<SpriteId>> cells;
+    // Indexed by sprite slot, slots are dense and reused so this stays small
+    std::vector<Entry> entries;
+    size_t count = 0;
+    float max_half_size = 0.f;
+};
+
+} // namespace Engine
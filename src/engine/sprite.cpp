@@ -1,45 +1,179 @@
 #include <pch.hpp>
 
 #include "sprite.hpp"
+#include "pipeline.hpp"
+#include "profiler.hpp"
+#include "sprite_kernels.hpp"
+#include "jobs/job_system.hpp"
+#include <algorithm>
+#include <atomic>
 #include "../gfx/buffer.hpp"
 #include "../gfx/opengl.hpp"
+#include "../gfx/renderer.hpp"
 
 namespace Engine {
 
+size_t SpriteColumns::size() const
+{
+    return x.size();
+}
+
+void SpriteColumns::push(glm::vec2 position, float scale)
+{
+    x.push_back(position.x);
+    y.push_back(position.y);
+    previous_x.push_back(position.x);
+    previous_y.push_back(position.y);
+    this->scale.push_back(scale);
+
+    const AtlasRegion untextured;
+    layer.push_back(untextured.layer);
+    u_min.push_back(untextured.uv_rect.x);
+    v_min.push_back(untextured.uv_rect.y);
+    u_max.push_back(untextured.uv_rect.z);
+    v_max.push_back(untextured.uv_rect.w);
+}
+
+void SpriteColumns::setRegion(size_t index, const AtlasRegion& region)
+{
+    layer[index] = region.layer;
+    u_min[index] = region.uv_rect.x;
+    v_min[index] = region.uv_rect.y;
+    u_max[index] = region.uv_rect.z;
+    v_max[index] = region.uv_rect.w;
+}
+
+AtlasRegion SpriteColumns::getRegion(size_t index) const
+{
+    return AtlasRegion {
+        .layer = layer[index],
+        .uv_rect = glm::vec4(u_min[index], v_min[index], u_max[index], v_max[index]),
+    };
+}
+
+void SpriteColumns::swapRemove(size_t index)
+{
+    for (auto* column : { &x, &y, &previous_x, &previous_y, &scale, &layer, &u_min, &v_min, &u_max, &v_max }) {
+        (*column)[index] = column->back();
+        column->pop_back();
+    }
+}
+
+void DirtyIds::mark(SpriteId id)
+{
+    const size_t slot = spriteSlot(id);
+    if (slot >= marked.size()) {
+        marked.resize(slot + 1, UNMARKED);
+    }
+    if (marked[slot] != id) {
+        marked[slot] = id;
+        ids.push_back(id);
+    }
+}
+
+bool DirtyIds::contains(SpriteId id) const
+{
+    const size_t slot = spriteSlot(id);
+    return slot < marked.size() && marked[slot] == id;
+}
+
+void DirtyIds::take(std::vector<SpriteId>& out)
+{
+    for (SpriteId id : ids) {
+        marked[spriteSlot(id)] = UNMARKED;
+    }
+    out.clear();
+    out.swap(ids);
+}
+
+void DirtyIds::clear()
+{
+    for (SpriteId id : ids) {
+        marked[spriteSlot(id)] = UNMARKED;
+    }
+    ids.clear();
+}
+
 Sprite::Sprite(SpriteManager* manager, SpriteId id)
     : manager(manager), id(id) 
 {
-    manager->updated_sprites.insert(id);
+
 }
 
 void Sprite::destroy()
 {
     if (manager != nullptr) {
-        manager->free_ids.insert(id);
+        manager->destroySprite(id);
         manager = nullptr;
     }
 }
 
+// Handles outlive their sprite, whether through destroy or another handle to the same
+// sprite. Dead ones read back defaults and ignore writes.
+
+size_t Sprite::getIndex() const
+{
+    return manager != nullptr ? manager->getIndex(id) : SpriteManager::NO_INDEX;
+}
+
 void Sprite::setPosition(glm::vec2 position)
 {
-    manager->sprite_data[getId()].position = position;
-    manager->updated_sprites.insert(id);
+    const size_t index = getIndex();
+    if (index != SpriteManager::NO_INDEX) {
+        manager->writePosition(index, id, position.x, position.y);
+    }
 }
 
 glm::vec2 Sprite::getPosition() const
 {
-    return manager->sprite_data[getId()].position;
+    const size_t index = getIndex();
+    if (index == SpriteManager::NO_INDEX) {
+        return glm::vec2(0.f, 0.f);
+    }
+    return glm::vec2(manager->sprites.x[index], manager->sprites.y[index]);
+}
+
+glm::vec2 Sprite::getRenderPosition(float alpha) const
+{
+    const size_t index = getIndex();
+    if (index == SpriteManager::NO_INDEX) {
+        return glm::vec2(0.f, 0.f);
+    }
+    const auto& sprites = manager->sprites;
+    return glm::vec2(
+        sprites.previous_x[index] + (sprites.x[index] - sprites.previous_x[index]) * alpha,
+        sprites.previous_y[index] + (sprites.y[index] - sprites.previous_y[index]) * alpha
+    );
 }
 
 void Sprite::setScale(float scale)
 {
-    manager->sprite_data[getId()].scale = scale;
-    manager->updated_sprites.insert(id);
+    const size_t index = getIndex();
+    if (index != SpriteManager::NO_INDEX) {
+        manager->sprites.scale[index] = scale;
+        manager->markUpdated(id);
+    }
 }
 
 float Sprite::getScale() const
 {
-    return manager->sprite_data[getId()].scale;
+    const size_t index = getIndex();
+    return index != SpriteManager::NO_INDEX ? manager->sprites.scale[index] : 1.f;
+}
+
+void Sprite::setTexture(const AtlasRegion& region)
+{
+    const size_t index = getIndex();
+    if (index != SpriteManager::NO_INDEX) {
+        manager->sprites.setRegion(index, region);
+        manager->markUpdated(id);
+    }
+}
+
+AtlasRegion Sprite::getTexture() const
+{
+    const size_t index = getIndex();
+    return index != SpriteManager::NO_INDEX ? manager->sprites.getRegion(index) : AtlasRegion {};
 }
 
 SpriteId Sprite::getId() const
@@ -47,74 +181,569 @@ SpriteId Sprite::getId() const
     return id;
 }
 
-SpriteManager::SpriteManager(const Shader& shader)
-    : shader(shader)
+SpriteBatch::SpriteBatch(SpriteManager* manager, std::vector<SpriteId> ids)
+    : manager(manager), ids(std::move(ids))
+{
+
+}
+
+size_t SpriteBatch::size() const
+{
+    return ids.size();
+}
+
+Sprite SpriteBatch::get(size_t index) const
+{
+    return Sprite { manager, ids.at(index) };
+}
+
+void SpriteBatch::destroy()
+{
+    if (manager != nullptr) {
+        for (SpriteId id : ids) {
+            manager->destroySprite(id);
+        }
+        ids.clear();
+        manager = nullptr;
+    }
+}
+
+// Sprites of the batch can be destroyed on their own through a handle from get, those are
+// skipped and read back like a dead Sprite does. So is everything once the batch itself
+// has been destroyed.
+
+void SpriteBatch::setPositions(std::span<const float> positions)
+{
+    if (manager == nullptr) {
+        return;
+    }
+    const size_t count = std::min(ids.size(), positions.size() / 2);
+    for (size_t i = 0; i < count; i++) {
+        const size_t index = manager->getIndex(ids[i]);
+        if (index != SpriteManager::NO_INDEX) {
+            manager->writePosition(index, ids[i], positions[i * 2], positions[i * 2 + 1]);
+        }
+    }
+}
+
+void SpriteBatch::getPositions(std::span<float> positions) const
+{
+    if (manager == nullptr) {
+        return;
+    }
+    const size_t count = std::min(ids.size(), positions.size() / 2);
+    const auto& sprites = manager->sprites;
+    for (size_t i = 0; i < count; i++) {
+        const size_t index = manager->getIndex(ids[i]);
+        const bool alive = index != SpriteManager::NO_INDEX;
+        positions[i * 2] = alive ? sprites.x[index] : 0.f;
+        positions[i * 2 + 1] = alive ? sprites.y[index] : 0.f;
+    }
+}
+
+void SpriteBatch::setScales(std::span<const float> scales)
+{
+    if (manager == nullptr) {
+        return;
+    }
+    const size_t count = std::min(ids.size(), scales.size());
+    for (size_t i = 0; i < count; i++) {
+        const size_t index = manager->getIndex(ids[i]);
+        if (index != SpriteManager::NO_INDEX) {
+            manager->sprites.scale[index] = scales[i];
+            manager->markUpdated(ids[i]);
+        }
+    }
+}
+
+void SpriteBatch::getScales(std::span<float> scales) const
+{
+    if (manager == nullptr) {
+        return;
+    }
+    const size_t count = std::min(ids.size(), scales.size());
+    for (size_t i = 0; i < count; i++) {
+        const size_t index = manager->getIndex(ids[i]);
+        scales[i] = index != SpriteManager::NO_INDEX ? manager->sprites.scale[index] : 1.f;
+    }
+}
+
+void SpriteBatch::setTexture(const AtlasRegion& region)
+{
+    if (manager == nullptr) {
+        return;
+    }
+    for (SpriteId id : ids) {
+        const size_t index = manager->getIndex(id);
+        if (index != SpriteManager::NO_INDEX) {
+            manager->sprites.setRegion(index, region);
+            manager->markUpdated(id);
+        }
+    }
+}
+
+SpriteManager::SpriteManager(const Shader& shader, JobSystem& jobs)
+    : shader(shader), jobs(jobs)
 {
     VertexBufferLayout layout = shader.getUniformLayout();
-    vert_array.addBuffer(vert_buffer, layout);
+    vert_array.addBuffer(instance_buffer, layout, AttributeRate::PerInstance);
+
+    shader.setUniform("sprite_atlas", static_cast<int>(ATLAS_TEXTURE_UNIT));
 }
 
-Sprite SpriteManager::createSprite()
+SpriteId SpriteManager::allocateSprite()
 {
     SpriteId id;
     if (!free_ids.empty()) {
-        id = *free_ids.begin();
-        free_ids.erase(id);
-        sprite_data[id] = SpriteData(id);
+        id = free_ids.back();
+        free_ids.pop_back();
     } else {
-        id = sprite_data.size();
-        sprite_data.push_back(SpriteData(id));
+        id = id_to_index.size();
+        id_to_index.push_back(NO_INDEX);
+        updated_flags.push_back(0);
+    }
+
+    id_to_index[spriteSlot(id)] = sprites.size();
+    index_to_id.push_back(id);
+    sprites.push(glm::vec2(0.f, 0.f), 1.f);
+    markUpdated(id);
+    if (in_fixed_step) {
+        spawned.mark(id);
+    }
+
+    return id;
+}
+
+Sprite SpriteManager::createSprite()
+{
+    return Sprite { this, allocateSprite() };
+}
+
+SpriteBatch SpriteManager::createSprites(size_t count)
+{
+    std::vector<SpriteId> ids;
+    ids.reserve(count);
+    for (size_t i = 0; i < count; i++) {
+        ids.push_back(allocateSprite());
     }
+    return SpriteBatch { this, std::move(ids) };
+}
+
+// Destroying a dead sprite does nothing, so any number of handles can try
+
+void SpriteManager::destroySprite(SpriteId id)
+{
+    const size_t index = getIndex(id);
+    if (index == NO_INDEX) {
+        return;
+    }
+    const SpriteId moved_id = index_to_id.back();
+
+    sprites.swapRemove(index);
+    index_to_id[index] = moved_id;
+    index_to_id.pop_back();
+    id_to_index[spriteSlot(moved_id)] = index;
+    id_to_index[spriteSlot(id)] = NO_INDEX;
+
+    free_ids.push_back(nextSpriteGeneration(id));
+    markUpdated(id);
+
+    for (const auto& listener : destroy_listeners) {
+        if (listener) {
+            listener(id);
+        }
+    }
+}
+
+size_t SpriteManager::getIndex(SpriteId id) const
+{
+    const size_t slot = spriteSlot(id);
+    if (slot >= id_to_index.size()) {
+        return NO_INDEX;
+    }
+    const size_t index = id_to_index[slot];
+    return index != NO_INDEX && index_to_id[index] == id ? index : NO_INDEX;
+}
 
+// Outside a fixed step there's no tick to interpolate across, the previous position moves
+// along so the sprite doesn't slide over from where it was
+
+void SpriteManager::writePosition(size_t index, SpriteId id, float x, float y)
+{
+    sprites.x[index] = x;
+    sprites.y[index] = y;
+    if (!in_fixed_step || spawned.contains(id)) {
+        sprites.previous_x[index] = x;
+        sprites.previous_y[index] = y;
+    }
+    markUpdated(id);
+}
+
+void SpriteManager::markUpdated(SpriteId id)
+{
+    if (!updated_flags[spriteSlot(id)]) {
+        updated_flags[spriteSlot(id)] = 1;
+        updated_sprites.push_back(id);
+    }
+    spatial_dirty.mark(id);
+    for (std::optional<DirtyIds>& listener : change_listeners) {
+        if (listener) {
+            listener->mark(id);
+        }
+    }
+}
+
+SpriteManager::ChangeListener SpriteManager::addChangeListener()
+{
+    change_listeners.emplace_back(DirtyIds {});
+    return change_listeners.size() - 1;
+}
+
+void SpriteManager::removeChangeListener(ChangeListener listener)
+{
+    change_listeners[listener] = std::nullopt;
+}
+
+void SpriteManager::takeChanges(ChangeListener listener, std::vector<SpriteId>& out)
+{
+    change_listeners[listener]->take(out);
+}
+
+SpriteManager::DestroyListener SpriteManager::addDestroyListener(std::function<void(SpriteId)> listener)
+{
+    destroy_listeners.push_back(std::move(listener));
+    return destroy_listeners.size() - 1;
+}
+
+void SpriteManager::removeDestroyListener(DestroyListener listener)
+{
+    destroy_listeners[listener] = nullptr;
+}
+
+bool SpriteManager::isAlive(SpriteId id) const
+{
+    return getIndex(id) != NO_INDEX;
+}
+
+glm::vec2 SpriteManager::getPosition(SpriteId id) const
+{
+    const size_t index = getIndex(id);
+    if (index == NO_INDEX) {
+        return glm::vec2(0.f, 0.f);
+    }
+    return glm::vec2(sprites.x[index], sprites.y[index]);
+}
+
+Sprite SpriteManager::getSprite(SpriteId id)
+{
     return Sprite { this, id };
 }
 
-void SpriteManager::render()
+void SpriteManager::getPositions(std::span<const SpriteId> ids, float* x, float* y) const
 {
-    std::vector<SpriteVertexData> vert_data;
-    
-    vert_array.bind();
-    
-    if (!updated_sprites.empty()) {
-        for (size_t i = 0; i < sprite_data.size(); i++) {
-            const auto& sprite = sprite_data[i];
-            if (free_ids.contains(sprite.id)) {
-                continue;
-            }
+    for (size_t i = 0; i < ids.size(); i++) {
+        const size_t index = getIndex(ids[i]);
+        x[i] = sprites.x[index];
+        y[i] = sprites.y[index];
+    }
+}
+
+void SpriteManager::setPositions(std::span<const SpriteId> ids, const float* x, const float* y)
+{
+    for (size_t i = 0; i < ids.size(); i++) {
+        writePosition(getIndex(ids[i]), ids[i], x[i], y[i]);
+    }
+}
+
+void SpriteManager::syncSpatialIndex()
+{
+    spatial_dirty.take(spatial_changes);
+    for (SpriteId id : spatial_changes) {
+        const size_t index = getIndex(id);
+        if (index == NO_INDEX) {
+            spatial_index.remove(id);
+        } else {
+            const glm::vec2 position(sprites.x[index], sprites.y[index]);
+            spatial_index.update(id, position, sprites.scale[index] * (SPRITE_SIZE * 0.5f));
+        }
+    }
+}
+
+const SpatialGrid& SpriteManager::getSpatialIndex()
+{
+    syncSpatialIndex();
+    return spatial_index;
+}
+
+std::vector<Sprite> SpriteManager::querySprites(const SpriteBounds& bounds)
+{
+    std::vector<SpriteId> ids;
+    getSpatialIndex().query(bounds, ids);
+
+    std::vector<Sprite> result;
+    result.reserve(ids.size());
+    for (SpriteId id : ids) {
+        result.push_back(Sprite { this, id });
+    }
+    return result;
+}
+
+std::vector<Sprite> SpriteManager::querySprites(glm::vec2 center, float radius)
+{
+    std::vector<SpriteId> ids;
+    getSpatialIndex().query(center, radius, ids);
+
+    std::vector<Sprite> result;
+    result.reserve(ids.size());
+    for (SpriteId id : ids) {
+        result.push_back(Sprite { this, id });
+    }
+    return result;
+}
+
+const SpriteColumns& SpriteManager::getColumns() const
+{
+    return sprites;
+}
+
+TextureAtlas& SpriteManager::getAtlas()
+{
+    return atlas;
+}
+
+void SpriteManager::setCullBounds(const std::optional<SpriteBounds>& bounds)
+{
+    const bool same = bounds.has_value() == cull_bounds.has_value()
+        && (!bounds || (bounds->min == cull_bounds->min && bounds->max == cull_bounds->max));
+    if (!same) {
+        cull_bounds = bounds;
+        cull_changed = true;
+    }
+}
+
+void SpriteManager::beginFixedStep()
+{
+    std::copy(sprites.x.begin(), sprites.x.end(), sprites.previous_x.begin());
+    std::copy(sprites.y.begin(), sprites.y.end(), sprites.previous_y.begin());
+    spawned.clear();
+    in_fixed_step = true;
+}
+
+void SpriteManager::endFixedStep()
+{
+    spawned.clear();
+    in_fixed_step = false;
+}
+
+std::shared_ptr<SpriteManager::PackedInstances> SpriteManager::acquirePackBuffer()
+{
+    // Buffers only ever get shared out from here, so once nobody else holds one it can't
+    // be picked up again behind our back
+    for (auto& buffer : pack_buffers) {
+        if (!buffer) {
+            buffer = std::make_shared<PackedInstances>();
+            return buffer;
+        }
+        if (buffer.use_count() == 1) {
+            std::atomic_thread_fence(std::memory_order_acquire);
+            return buffer;
+        }
+    }
+    return std::make_shared<PackedInstances>();
+}
+
+// Instances outside the view are dropped by moving the visible ones down, returns how many
+// are left
+
+static size_t keepVisible(SpriteInstanceData* instances, size_t count, const SpriteBounds& view)
+{
+    size_t kept = 0;
+    for (size_t i = 0; i < count; i++) {
+        const SpriteInstanceData instance = instances[i];
+        const float half_size = instance.scale * (SPRITE_SIZE * 0.5f);
+        const bool visible = instance.x + half_size >= view.min.x && instance.x - half_size <= view.max.x
+            && instance.y + half_size >= view.min.y && instance.y - half_size <= view.max.y;
+        if (visible) {
+            instances[kept++] = instance;
+        }
+    }
+    return kept;
+}
+
+// Blocks are rejected by where their sprites are at the end of the tick. A sprite moving
+// more than CULL_MARGIN in a tick can show up one frame late at the edge of the screen.
+
+size_t SpriteManager::packRange(size_t first, size_t last, float alpha, SpriteInstanceData* out, bool& moving) const
+{
+    const SpriteKernels& kernels = getSpriteKernels();
+    if (!cull_bounds) {
+        moving = kernels.pack(sprites, first, last, alpha, out);
+        return last - first;
+    }
+
+    const SpriteBounds block_view {
+        .min = cull_bounds->min - CULL_MARGIN,
+        .max = cull_bounds->max + CULL_MARGIN,
+    };
+    size_t written = 0;
+    moving = false;
+    for (size_t block = first; block < last; block += CULL_BLOCK_SIZE) {
+        const size_t block_last = std::min(block + CULL_BLOCK_SIZE, last);
+        if (!kernels.bounds(sprites, block, block_last).overlaps(block_view)) {
+            continue;
+        }
+        moving |= kernels.pack(sprites, block, block_last, alpha, out + written);
+        written += keepVisible(out + written, block_last - block, *cull_bounds);
+    }
+    return written;
+}
 
-            auto data = SpriteVertexData {
-                .index = 0,
-                .x = sprite.position.x,
-                .y = sprite.position.y,
-                .scale = sprite.scale,
-            };
+// With only a small part of the world on screen, looking the visible sprites up in the
+// grid beats going over every block. Empty when culling is off or so much is visible
+// that the block pass is cheaper.
 
-            for (unsigned int j = 0; j < 6; j++) {
-                data.index = j;
-                vert_data.push_back(data);
+std::optional<size_t> SpriteManager::packFromIndex(float alpha, SpriteInstanceData* out, bool& moving)
+{
+    if (!cull_bounds) {
+        return std::nullopt;
+    }
+
+    syncSpatialIndex();
+    const SpriteBounds view {
+        .min = cull_bounds->min - CULL_MARGIN,
+        .max = cull_bounds->max + CULL_MARGIN,
+    };
+    visible_indices.clear();
+    spatial_index.query(view, visible_indices);
+    if (visible_indices.size() > sprites.size() / INDEX_CULL_FRACTION) {
+        return std::nullopt;
+    }
+
+    // Back to sprite order so the draw order doesn't depend on the grid, which also turns
+    // sprites created together into runs the pack kernel can take in one go
+    for (size_t& index : visible_indices) {
+        index = getIndex(index);
+    }
+    std::sort(visible_indices.begin(), visible_indices.end());
+
+    const SpriteKernels& kernels = getSpriteKernels();
+    size_t written = 0;
+    moving = false;
+    for (size_t run = 0; run < visible_indices.size();) {
+        size_t run_end = run + 1;
+        while (run_end < visible_indices.size() && visible_indices[run_end] == visible_indices[run_end - 1] + 1) {
+            run_end++;
+        }
+        const size_t first = visible_indices[run];
+        const size_t last = visible_indices[run_end - 1] + 1;
+        moving |= kernels.pack(sprites, first, last, alpha, out + written);
+        written += last - first;
+        run = run_end;
+    }
+    return keepVisible(out, written, *cull_bounds);
+}
+
+void SpriteManager::pack(RenderSnapshot& snapshot, float alpha)
+{
+    PROFILE_SCOPE("SpriteManager::pack");
+
+    // Sprites drawn part way between two ticks have to be repacked every frame until
+    // they settle, even if nothing touched them this frame
+    if (!updated_sprites.empty() || interpolating || cull_changed || !packed) {
+        packed = nullptr;
+        cull_changed = false;
+
+        const size_t count = sprites.size();
+
+        std::shared_ptr<PackedInstances> instances = acquirePackBuffer();
+        instances->resize(count);
+        SpriteInstanceData* out = instances->data();
+
+        bool index_moving = false;
+        if (const std::optional<size_t> written = packFromIndex(alpha, out, index_moving)) {
+            instances->resize(*written);
+            interpolating = index_moving;
+        } else if (count < PARALLEL_PACK_THRESHOLD) {
+            bool moving = false;
+            instances->resize(packRange(0, count, alpha, out, moving));
+            interpolating = moving;
+        } else {
+            // Sprites are dense so every chunk knows where its slice of the buffer starts,
+            // culled chunks come up short and get moved together afterwards
+            const size_t chunk_count = (count + PACK_CHUNK_SIZE - 1) / PACK_CHUNK_SIZE;
+            std::vector<char> moving(chunk_count, 0);
+            std::vector<size_t> written(chunk_count, 0);
+
+            jobs.parallelFor(0, chunk_count, 1, [&](size_t begin, size_t end) {
+                PROFILE_SCOPE("SpriteManager::pack chunk");
+                for (size_t chunk = begin; chunk < end; chunk++) {
+                    const size_t first = chunk * PACK_CHUNK_SIZE;
+                    const size_t last = std::min(first + PACK_CHUNK_SIZE, count);
+                    bool chunk_moving = false;
+                    written[chunk] = packRange(first, last, alpha, out + first, chunk_moving);
+                    moving[chunk] = chunk_moving;
+                }
+            });
+
+            size_t total = written[0];
+            for (size_t chunk = 1; chunk < chunk_count; chunk++) {
+                const SpriteInstanceData* chunk_out = out + chunk * PACK_CHUNK_SIZE;
+                std::copy(chunk_out, chunk_out + written[chunk], out + total);
+                total += written[chunk];
             }
+            instances->resize(total);
+            interpolating = std::any_of(moving.begin(), moving.end(), [](char chunk) { return chunk != 0; });
         }
 
-        vert_array.bind();
-        vert_buffer.buffer(
-            static_cast<const void*>(&vert_data[0]),
-            vert_data.size() * sizeof(SpriteVertexData)
-        );
+        packed = std::move(instances);
     }
-    
-    vert_array.unbind();
-    shader.use();
-    vert_array.bind();
 
-    if (!vert_buffer.isEmpty()) {
-        OPENGL_CALL(glDrawArrays(
-            GL_TRIANGLES,
-            0,
-            static_cast<GLsizei>((sprite_data.size() - free_ids.size()) * 6)
-        ));
+    snapshot.sprite_instances = packed;
+    snapshot.atlas_update = atlas.takeUpdate();
+    for (SpriteId id : updated_sprites) {
+        updated_flags[spriteSlot(id)] = 0;
     }
-        
     updated_sprites.clear();
 }
 
+void SpriteManager::draw(const RenderSnapshot& snapshot, Renderer& renderer)
+{
+    PROFILE_SCOPE("SpriteManager::draw");
+
+    atlas.upload(snapshot.atlas_update);
+
+    const auto& instances = snapshot.sprite_instances;
+    if (!instances) {
+        return;
+    }
+
+    if (instances != uploaded && !instances->empty()) {
+        instance_buffer.buffer(
+            static_cast<const void*>(instances->data()),
+            instances->size() * sizeof(SpriteInstanceData)
+        );
+    }
+    uploaded = instances;
+
+    if (instance_buffer.isEmpty() || instances->empty()) {
+        return;
+    }
+
+    renderer.submit(DrawCommand {
+        .key = makeSortKey(SortKeyFields {
+            .layer = DRAW_LAYER,
+            .shader = shader.getProgram(),
+            .texture = atlas.getHandle(),
+        }),
+        .program = shader.getProgram(),
+        .vertex_array = vert_array.getHandle(),
+        .texture = atlas.getHandle(),
+        .texture_target = GL_TEXTURE_2D_ARRAY,
+        .texture_unit = ATLAS_TEXTURE_UNIT,
+        .primitive = GL_TRIANGLES,
+        .count = static_cast<int>(VERTICES_PER_SPRITE),
+        .instance_count = static_cast<int>(instances->size()),
+    });
+}
+
 } // namespace Engine
@@ -1,10 +1,18 @@
 #pragma once
 
+#include "spatial_grid.hpp"
 #include "../gfx/array.hpp"
+#include "../gfx/texture_atlas.hpp"
 #include "../resource/shader.hpp"
 #include "../constructors.hpp"
 #include "../platform.hpp"
-#include <unordered_set>
+#include <array>
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <memory>
+#include <optional>
+#include <span>
 
 namespace sol {
     class state;
@@ -12,15 +20,21 @@ namespace sol {
 
 namespace Engine {
 
-using SpriteId = size_t;
-
 class SpriteManager;
+class JobSystem;
+class Renderer;
+struct RenderSnapshot;
 
-GAME_PACKED_STRUCT(SpriteVertexData, {
-    GLuint index = 0;
+// One per sprite, the shader builds the quad from gl_VertexID
+GAME_PACKED_STRUCT(SpriteInstanceData, {
     float x = 0.f;
     float y = 0.f;
     float scale = 1.f;
+    float layer = AtlasRegion::UNTEXTURED;
+    float u_min = 0.f;
+    float v_min = 0.f;
+    float u_max = 1.f;
+    float v_max = 1.f;
 });
 
 class Sprite {
@@ -34,42 +48,215 @@ public:
     void destroy();
     void setPosition(glm::vec2 position);
     glm::vec2 getPosition() const;
+    // Where the sprite gets drawn when packed with the same alpha
+    glm::vec2 getRenderPosition(float alpha) const;
     void setScale(float scale);
     float getScale() const;
+    void setTexture(const AtlasRegion& region);
+    AtlasRegion getTexture() const;
     SpriteId getId() const;
 
 private:
+    // Where the sprite lives in the columns, NO_INDEX once it's been destroyed
+    size_t getIndex() const;
+
     SpriteManager* manager;
     SpriteId id = 0;
 
     friend SpriteManager;
 };
 
-struct SpriteData {
-    SpriteData(SpriteId id) 
-        : id(id) {}
-    glm::vec2 position = glm::vec2(0.f, 0.f);
-    float scale = 1.f;
-    SpriteId id;
+// Handle to a group of sprites created together so scripts can move all of them with
+// one call instead of crossing into C++ once per sprite
+
+class SpriteBatch {
+private:
+    SpriteBatch(SpriteManager* manager, std::vector<SpriteId> ids);
+
+public:
+    DELETE_COPY(SpriteBatch);
+    DEFAULT_MOVE(SpriteBatch);
+
+    size_t size() const;
+    // Destroying the handle leaves a dead slot in the batch that the other calls skip
+    Sprite get(size_t index) const;
+    void destroy();
+
+    // Positions are interleaved x, y pairs. Extra values are ignored and missing ones
+    // leave the remaining sprites untouched.
+    void setPositions(std::span<const float> positions);
+    void getPositions(std::span<float> positions) const;
+    void setScales(std::span<const float> scales);
+    void getScales(std::span<float> scales) const;
+    void setTexture(const AtlasRegion& region);
+
+private:
+    SpriteManager* manager;
+    std::vector<SpriteId> ids;
+
+    friend SpriteManager;
+};
+
+// Sprite state is stored column wise and densely packed, destroying a sprite moves the
+// last one into its slot. Keeps the bulk passes over it streaming through memory and
+// easy to vectorize.
+
+struct SpriteColumns {
+    std::vector<float> x;
+    std::vector<float> y;
+    // Position at the start of the current fixed step, used to interpolate between ticks
+    std::vector<float> previous_x;
+    std::vector<float> previous_y;
+    std::vector<float> scale;
+    // Atlas layer and UV rect, see AtlasRegion
+    std::vector<float> layer;
+    std::vector<float> u_min;
+    std::vector<float> v_min;
+    std::vector<float> u_max;
+    std::vector<float> v_max;
+
+    size_t size() const;
+    void push(glm::vec2 position, float scale);
+    void setRegion(size_t index, const AtlasRegion& region);
+    AtlasRegion getRegion(size_t index) const;
+    void swapRemove(size_t index);
+};
+
+// Ids touched since whoever owns the list last took them. The marks are indexed by slot and
+// keep the list unique, a reused slot gets its new id listed after the old one.
+
+struct DirtyIds {
+    constexpr static SpriteId UNMARKED = std::numeric_limits<SpriteId>::max();
+
+    std::vector<SpriteId> ids;
+    std::vector<SpriteId> marked;
+
+    void mark(SpriteId id);
+    bool contains(SpriteId id) const;
+    // Moves the ids into out, which is cleared first
+    void take(std::vector<SpriteId>& out);
+    void clear();
 };
 
 class SpriteManager {
 public:
-    SpriteManager(const Shader& shader);
+    // Lets other systems follow sprite changes without scanning every sprite
+    using ChangeListener = size_t;
+    using DestroyListener = size_t;
+
+    // Every sprite is an instance of one quad
+    constexpr static size_t VERTICES_PER_SPRITE = 6;
+    // Texture unit the atlas is bound to while drawing
+    constexpr static unsigned int ATLAS_TEXTURE_UNIT = 0;
+    // Render queue layer sprites are drawn on
+    constexpr static uint8_t DRAW_LAYER = 0;
+    // Below this many sprites handing the packing out to workers costs more than it saves
+    constexpr static size_t PARALLEL_PACK_THRESHOLD = 16384;
+    constexpr static size_t PACK_CHUNK_SIZE = 4096;
+    // Culling first rejects whole blocks by their bounds, then single sprites
+    constexpr static size_t CULL_BLOCK_SIZE = 256;
+    constexpr static float CULL_MARGIN = 100.f;
+    // Culling looks visible sprites up in the spatial index instead when at most this
+    // fraction of them can be on screen
+    constexpr static size_t INDEX_CULL_FRACTION = 4;
+
+    SpriteManager(const Shader& shader, JobSystem& jobs);
 
     Sprite createSprite();
-    void render();
+    SpriteBatch createSprites(size_t count);
+    // Positions set between these two are drawn interpolated from where the sprite was at
+    // the start of the step, anywhere else they take effect immediately. So do the first
+    // positions of sprites created during the step.
+    void beginFixedStep();
+    void endFixedStep();
+    // Sprites entirely outside the box aren't packed or drawn, empty draws everything
+    void setCullBounds(const std::optional<SpriteBounds>& bounds);
+
+    // Packing runs on the simulation thread and only touches sprite state, drawing runs
+    // on the render thread and only touches GL objects. Drawing only submits to the
+    // renderer's queue, nothing shows up until it's flushed.
+    void pack(RenderSnapshot& snapshot, float alpha = 1.f);
+    void draw(const RenderSnapshot& snapshot, Renderer& renderer);
+
+    // Sprites overlapping the box or circle, from the spatial index
+    std::vector<Sprite> querySprites(const SpriteBounds& bounds);
+    std::vector<Sprite> querySprites(glm::vec2 center, float radius);
+    // Brings the index up to date with every sprite touched since the last call
+    const SpatialGrid& getSpatialIndex();
+
+    // Each listener sees every sprite touched since it last took its changes, destroyed ones
+    // included
+    ChangeListener addChangeListener();
+    void removeChangeListener(ChangeListener listener);
+    void takeChanges(ChangeListener listener, std::vector<SpriteId>& out);
+    // Called from destroy, before the id can be handed to a new sprite. Listeners that
+    // capture something have to be removed before it goes away.
+    DestroyListener addDestroyListener(std::function<void(SpriteId)> listener);
+    void removeDestroyListener(DestroyListener listener);
+
+    bool isAlive(SpriteId id) const;
+    // Zero for a destroyed sprite, same as Sprite::getPosition
+    glm::vec2 getPosition(SpriteId id) const;
+    Sprite getSprite(SpriteId id);
+    // Column wise positions for systems that keep their own list of sprites, every id has
+    // to be alive
+    void getPositions(std::span<const SpriteId> ids, float* x, float* y) const;
+    void setPositions(std::span<const SpriteId> ids, const float* x, const float* y);
+
+    const SpriteColumns& getColumns() const;
+    TextureAtlas& getAtlas();
 
 private:
-    std::vector<SpriteData> sprite_data;
-    std::unordered_set<SpriteId> free_ids;
-    std::unordered_set<SpriteId> updated_sprites;
+    using PackedInstances = std::vector<SpriteInstanceData>;
+
+    constexpr static size_t NO_INDEX = std::numeric_limits<size_t>::max();
+
+    std::shared_ptr<PackedInstances> acquirePackBuffer();
+    size_t packRange(size_t first, size_t last, float alpha, SpriteInstanceData* out, bool& moving) const;
+    std::optional<size_t> packFromIndex(float alpha, SpriteInstanceData* out, bool& moving);
+    void syncSpatialIndex();
+    SpriteId allocateSprite();
+    void destroySprite(SpriteId id);
+    size_t getIndex(SpriteId id) const;
+    void markUpdated(SpriteId id);
+    void writePosition(size_t index, SpriteId id, float x, float y);
+
+    SpriteColumns sprites;
+    // Indexed by slot, the id at the index has to match for the sprite to be alive
+    std::vector<size_t> id_to_index;
+    std::vector<SpriteId> index_to_id;
+    std::vector<SpriteId> free_ids;
+    // Ids touched since the last pack, the flags are indexed by slot and keep the list unique
+    std::vector<SpriteId> updated_sprites;
+    std::vector<char> updated_flags;
+    // Same for the spatial index, which can be synced between packs by queries
+    DirtyIds spatial_dirty;
+    std::vector<SpriteId> spatial_changes;
+    SpatialGrid spatial_index;
+    // Removed listeners leave an empty slot so the handles of the others stay valid
+    std::vector<std::optional<DirtyIds>> change_listeners;
+    std::vector<std::function<void(SpriteId)>> destroy_listeners;
+    std::vector<size_t> visible_indices;
+    bool interpolating = false;
+    bool in_fixed_step = false;
+    // Created since the step began, these have nothing to interpolate from yet
+    DirtyIds spawned;
+    std::optional<SpriteBounds> cull_bounds;
+    bool cull_changed = false;
+
+    // A few buffers are kept around so packing can reuse one the render thread is done with
+    std::array<std::shared_ptr<PackedInstances>, 3> pack_buffers;
+    std::shared_ptr<const PackedInstances> packed;
 
+    std::shared_ptr<const PackedInstances> uploaded;
     VertexArray vert_array;
-    VertexBuffer vert_buffer;
+    VertexBuffer instance_buffer;
+    TextureAtlas atlas;
     const Shader& shader;
+    JobSystem& jobs;
 
     friend Sprite;
+    friend SpriteBatch;
 };
 
 } // namespace Engine
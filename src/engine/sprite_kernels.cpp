@@ -0,0 +1,419 @@
+#include <pch.hpp>
+
+#include "sprite_kernels.hpp"
+#include "simd.hpp"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace Engine {
+
+static_assert(sizeof(SpriteInstanceData) == 8 * sizeof(float), "SIMD packing stores whole instances as two SSE or one AVX vector");
+
+// Interpolation is written out as a mul and an add everywhere, no FMA, so every level
+// rounds the same way
+
+bool packScalar(const SpriteColumns& sprites, size_t first, size_t last, float alpha, SpriteInstanceData* out)
+{
+    bool moving = false;
+    for (size_t i = first; i < last; i++) {
+        const float x = sprites.x[i];
+        const float y = sprites.y[i];
+        const float previous_x = sprites.previous_x[i];
+        const float previous_y = sprites.previous_y[i];
+        moving |= previous_x != x || previous_y != y;
+
+        *out++ = SpriteInstanceData {
+            .x = previous_x + (x - previous_x) * alpha,
+            .y = previous_y + (y - previous_y) * alpha,
+            .scale = sprites.scale[i],
+            .layer = sprites.layer[i],
+            .u_min = sprites.u_min[i],
+            .v_min = sprites.v_min[i],
+            .u_max = sprites.u_max[i],
+            .v_max = sprites.v_max[i],
+        };
+    }
+    return moving;
+}
+
+void integrateScalar(float* x, float* y, const float* velocity_x, const float* velocity_y, size_t count, float delta_time)
+{
+    for (size_t i = 0; i < count; i++) {
+        x[i] += velocity_x[i] * delta_time;
+        y[i] += velocity_y[i] * delta_time;
+    }
+}
+
+void accelerateScalar(
+    float* velocity_x, float* velocity_y,
+    const float* acceleration_x, const float* acceleration_y,
+    const float* damping, const float* max_speed,
+    size_t count, float delta_time
+)
+{
+    for (size_t i = 0; i < count; i++) {
+        const float x = velocity_x[i] + (acceleration_x[i] - velocity_x[i] * damping[i]) * delta_time;
+        const float y = velocity_y[i] + (acceleration_y[i] - velocity_y[i] * damping[i]) * delta_time;
+        const float speed_squared = x * x + y * y;
+        const float limit = max_speed[i];
+        const float scale = speed_squared > limit * limit ? limit / std::sqrt(speed_squared) : 1.f;
+        velocity_x[i] = x * scale;
+        velocity_y[i] = y * scale;
+    }
+}
+
+SpriteBounds boundsScalar(const SpriteColumns& sprites, size_t first, size_t last)
+{
+    SpriteBounds bounds {
+        .min = glm::vec2(std::numeric_limits<float>::max()),
+        .max = glm::vec2(std::numeric_limits<float>::lowest()),
+    };
+    for (size_t i = first; i < last; i++) {
+        const float half_size = sprites.scale[i] * (SPRITE_SIZE * 0.5f);
+        bounds.min.x = std::min(bounds.min.x, sprites.x[i] - half_size);
+        bounds.min.y = std::min(bounds.min.y, sprites.y[i] - half_size);
+        bounds.max.x = std::max(bounds.max.x, sprites.x[i] + half_size);
+        bounds.max.y = std::max(bounds.max.y, sprites.y[i] + half_size);
+    }
+    return bounds;
+}
+
+#if defined(GAME_SIMD_SSE2)
+
+bool packSSE2(const SpriteColumns& sprites, size_t first, size_t last, float alpha, SpriteInstanceData* out)
+{
+    const __m128 alpha4 = _mm_set1_ps(alpha);
+
+    __m128 changed = _mm_setzero_ps();
+    // Stores are unaligned, the packed struct only ever gets written as whole vectors here
+    char* dst = reinterpret_cast<char*>(out);
+
+    size_t i = first;
+    for (; i + 4 <= last; i += 4) {
+        const __m128 x = _mm_loadu_ps(&sprites.x[i]);
+        const __m128 y = _mm_loadu_ps(&sprites.y[i]);
+        const __m128 previous_x = _mm_loadu_ps(&sprites.previous_x[i]);
+        const __m128 previous_y = _mm_loadu_ps(&sprites.previous_y[i]);
+        changed = _mm_or_ps(changed, _mm_or_ps(_mm_cmpneq_ps(previous_x, x), _mm_cmpneq_ps(previous_y, y)));
+
+        // Columns in, one { x, y, scale, layer } and one UV rect row per sprite out
+        __m128 position0 = _mm_add_ps(previous_x, _mm_mul_ps(_mm_sub_ps(x, previous_x), alpha4));
+        __m128 position1 = _mm_add_ps(previous_y, _mm_mul_ps(_mm_sub_ps(y, previous_y), alpha4));
+        __m128 position2 = _mm_loadu_ps(&sprites.scale[i]);
+        __m128 position3 = _mm_loadu_ps(&sprites.layer[i]);
+        _MM_TRANSPOSE4_PS(position0, position1, position2, position3);
+
+        __m128 uv0 = _mm_loadu_ps(&sprites.u_min[i]);
+        __m128 uv1 = _mm_loadu_ps(&sprites.v_min[i]);
+        __m128 uv2 = _mm_loadu_ps(&sprites.u_max[i]);
+        __m128 uv3 = _mm_loadu_ps(&sprites.v_max[i]);
+        _MM_TRANSPOSE4_PS(uv0, uv1, uv2, uv3);
+
+        const __m128 rows[4][2] = {
+            { position0, uv0 },
+            { position1, uv1 },
+            { position2, uv2 },
+            { position3, uv3 },
+        };
+        for (const auto& row : rows) {
+            _mm_storeu_ps(reinterpret_cast<float*>(dst), row[0]);
+            _mm_storeu_ps(reinterpret_cast<float*>(dst) + 4, row[1]);
+            dst += sizeof(SpriteInstanceData);
+        }
+    }
+
+    bool moving = _mm_movemask_ps(changed) != 0;
+    if (i < last) {
+        moving |= packScalar(sprites, i, last, alpha, out + (i - first));
+    }
+    return moving;
+}
+
+void integrateSSE2(float* x, float* y, const float* velocity_x, const float* velocity_y, size_t count, float delta_time)
+{
+    const __m128 delta4 = _mm_set1_ps(delta_time);
+
+    size_t i = 0;
+    for (; i + 4 <= count; i += 4) {
+        _mm_storeu_ps(&x[i], _mm_add_ps(_mm_loadu_ps(&x[i]), _mm_mul_ps(_mm_loadu_ps(&velocity_x[i]), delta4)));
+        _mm_storeu_ps(&y[i], _mm_add_ps(_mm_loadu_ps(&y[i]), _mm_mul_ps(_mm_loadu_ps(&velocity_y[i]), delta4)));
+    }
+    integrateScalar(x + i, y + i, velocity_x + i, velocity_y + i, count - i, delta_time);
+}
+
+// Same steps as the scalar version, the clamp is picked per lane with a mask
+
+void accelerateSSE2(
+    float* velocity_x, float* velocity_y,
+    const float* acceleration_x, const float* acceleration_y,
+    const float* damping, const float* max_speed,
+    size_t count, float delta_time
+)
+{
+    const __m128 delta4 = _mm_set1_ps(delta_time);
+    const __m128 one = _mm_set1_ps(1.f);
+
+    size_t i = 0;
+    for (; i + 4 <= count; i += 4) {
+        const __m128 old_x = _mm_loadu_ps(&velocity_x[i]);
+        const __m128 old_y = _mm_loadu_ps(&velocity_y[i]);
+        const __m128 drag = _mm_loadu_ps(&damping[i]);
+        const __m128 x = _mm_add_ps(old_x, _mm_mul_ps(_mm_sub_ps(_mm_loadu_ps(&acceleration_x[i]), _mm_mul_ps(old_x, drag)), delta4));
+        const __m128 y = _mm_add_ps(old_y, _mm_mul_ps(_mm_sub_ps(_mm_loadu_ps(&acceleration_y[i]), _mm_mul_ps(old_y, drag)), delta4));
+
+        const __m128 speed_squared = _mm_add_ps(_mm_mul_ps(x, x), _mm_mul_ps(y, y));
+        const __m128 limit = _mm_loadu_ps(&max_speed[i]);
+        const __m128 over = _mm_cmpgt_ps(speed_squared, _mm_mul_ps(limit, limit));
+        const __m128 clamped = _mm_div_ps(limit, _mm_sqrt_ps(speed_squared));
+        const __m128 scale = _mm_or_ps(_mm_and_ps(over, clamped), _mm_andnot_ps(over, one));
+
+        _mm_storeu_ps(&velocity_x[i], _mm_mul_ps(x, scale));
+        _mm_storeu_ps(&velocity_y[i], _mm_mul_ps(y, scale));
+    }
+    accelerateScalar(
+        velocity_x + i, velocity_y + i,
+        acceleration_x + i, acceleration_y + i,
+        damping + i, max_speed + i,
+        count - i, delta_time
+    );
+}
+
+SpriteBounds boundsSSE2(const SpriteColumns& sprites, size_t first, size_t last)
+{
+    const __m128 half = _mm_set1_ps(SPRITE_SIZE * 0.5f);
+    __m128 min_x = _mm_set1_ps(std::numeric_limits<float>::max());
+    __m128 min_y = min_x;
+    __m128 max_x = _mm_set1_ps(std::numeric_limits<float>::lowest());
+    __m128 max_y = max_x;
+
+    size_t i = first;
+    for (; i + 4 <= last; i += 4) {
+        const __m128 x = _mm_loadu_ps(&sprites.x[i]);
+        const __m128 y = _mm_loadu_ps(&sprites.y[i]);
+        const __m128 half_size = _mm_mul_ps(_mm_loadu_ps(&sprites.scale[i]), half);
+        min_x = _mm_min_ps(min_x, _mm_sub_ps(x, half_size));
+        min_y = _mm_min_ps(min_y, _mm_sub_ps(y, half_size));
+        max_x = _mm_max_ps(max_x, _mm_add_ps(x, half_size));
+        max_y = _mm_max_ps(max_y, _mm_add_ps(y, half_size));
+    }
+
+    SpriteBounds bounds = boundsScalar(sprites, i, last);
+    bounds.min.x = std::min(bounds.min.x, horizontalMin(min_x));
+    bounds.min.y = std::min(bounds.min.y, horizontalMin(min_y));
+    bounds.max.x = std::max(bounds.max.x, horizontalMax(max_x));
+    bounds.max.y = std::max(bounds.max.y, horizontalMax(max_y));
+    return bounds;
+}
+
+#endif
+
+#if defined(GAME_SIMD_AVX2)
+
+// Eight columns of eight sprites in, eight instances out
+
+GAME_TARGET_AVX2
+static void transpose8(__m256 rows[8])
+{
+    const __m256 t0 = _mm256_unpacklo_ps(rows[0], rows[1]);
+    const __m256 t1 = _mm256_unpackhi_ps(rows[0], rows[1]);
+    const __m256 t2 = _mm256_unpacklo_ps(rows[2], rows[3]);
+    const __m256 t3 = _mm256_unpackhi_ps(rows[2], rows[3]);
+    const __m256 t4 = _mm256_unpacklo_ps(rows[4], rows[5]);
+    const __m256 t5 = _mm256_unpackhi_ps(rows[4], rows[5]);
+    const __m256 t6 = _mm256_unpacklo_ps(rows[6], rows[7]);
+    const __m256 t7 = _mm256_unpackhi_ps(rows[6], rows[7]);
+
+    const __m256 s0 = _mm256_shuffle_ps(t0, t2, _MM_SHUFFLE(1, 0, 1, 0));
+    const __m256 s1 = _mm256_shuffle_ps(t0, t2, _MM_SHUFFLE(3, 2, 3, 2));
+    const __m256 s2 = _mm256_shuffle_ps(t1, t3, _MM_SHUFFLE(1, 0, 1, 0));
+    const __m256 s3 = _mm256_shuffle_ps(t1, t3, _MM_SHUFFLE(3, 2, 3, 2));
+    const __m256 s4 = _mm256_shuffle_ps(t4, t6, _MM_SHUFFLE(1, 0, 1, 0));
+    const __m256 s5 = _mm256_shuffle_ps(t4, t6, _MM_SHUFFLE(3, 2, 3, 2));
+    const __m256 s6 = _mm256_shuffle_ps(t5, t7, _MM_SHUFFLE(1, 0, 1, 0));
+    const __m256 s7 = _mm256_shuffle_ps(t5, t7, _MM_SHUFFLE(3, 2, 3, 2));
+
+    rows[0] = _mm256_permute2f128_ps(s0, s4, 0x20);
+    rows[1] = _mm256_permute2f128_ps(s1, s5, 0x20);
+    rows[2] = _mm256_permute2f128_ps(s2, s6, 0x20);
+    rows[3] = _mm256_permute2f128_ps(s3, s7, 0x20);
+    rows[4] = _mm256_permute2f128_ps(s0, s4, 0x31);
+    rows[5] = _mm256_permute2f128_ps(s1, s5, 0x31);
+    rows[6] = _mm256_permute2f128_ps(s2, s6, 0x31);
+    rows[7] = _mm256_permute2f128_ps(s3, s7, 0x31);
+}
+
+GAME_TARGET_AVX2
+bool packAVX2(const SpriteColumns& sprites, size_t first, size_t last, float alpha, SpriteInstanceData* out)
+{
+    const __m256 alpha8 = _mm256_set1_ps(alpha);
+
+    __m256 changed = _mm256_setzero_ps();
+    // Stores are unaligned, the packed struct only ever gets written as whole vectors here
+    char* dst = reinterpret_cast<char*>(out);
+
+    size_t i = first;
+    for (; i + 8 <= last; i += 8) {
+        const __m256 x = _mm256_loadu_ps(&sprites.x[i]);
+        const __m256 y = _mm256_loadu_ps(&sprites.y[i]);
+        const __m256 previous_x = _mm256_loadu_ps(&sprites.previous_x[i]);
+        const __m256 previous_y = _mm256_loadu_ps(&sprites.previous_y[i]);
+        changed = _mm256_or_ps(changed, _mm256_or_ps(
+            _mm256_cmp_ps(previous_x, x, _CMP_NEQ_UQ),
+            _mm256_cmp_ps(previous_y, y, _CMP_NEQ_UQ)
+        ));
+
+        __m256 rows[8] = {
+            _mm256_add_ps(previous_x, _mm256_mul_ps(_mm256_sub_ps(x, previous_x), alpha8)),
+            _mm256_add_ps(previous_y, _mm256_mul_ps(_mm256_sub_ps(y, previous_y), alpha8)),
+            _mm256_loadu_ps(&sprites.scale[i]),
+            _mm256_loadu_ps(&sprites.layer[i]),
+            _mm256_loadu_ps(&sprites.u_min[i]),
+            _mm256_loadu_ps(&sprites.v_min[i]),
+            _mm256_loadu_ps(&sprites.u_max[i]),
+            _mm256_loadu_ps(&sprites.v_max[i]),
+        };
+        transpose8(rows);
+
+        for (const __m256 instance : rows) {
+            _mm256_storeu_ps(reinterpret_cast<float*>(dst), instance);
+            dst += sizeof(SpriteInstanceData);
+        }
+    }
+
+    bool moving = _mm256_movemask_ps(changed) != 0;
+    if (i < last) {
+        moving |= packScalar(sprites, i, last, alpha, out + (i - first));
+    }
+    return moving;
+}
+
+GAME_TARGET_AVX2
+void integrateAVX2(float* x, float* y, const float* velocity_x, const float* velocity_y, size_t count, float delta_time)
+{
+    const __m256 delta8 = _mm256_set1_ps(delta_time);
+
+    size_t i = 0;
+    for (; i + 8 <= count; i += 8) {
+        _mm256_storeu_ps(&x[i], _mm256_add_ps(_mm256_loadu_ps(&x[i]), _mm256_mul_ps(_mm256_loadu_ps(&velocity_x[i]), delta8)));
+        _mm256_storeu_ps(&y[i], _mm256_add_ps(_mm256_loadu_ps(&y[i]), _mm256_mul_ps(_mm256_loadu_ps(&velocity_y[i]), delta8)));
+    }
+    integrateScalar(x + i, y + i, velocity_x + i, velocity_y + i, count - i, delta_time);
+}
+
+GAME_TARGET_AVX2
+void accelerateAVX2(
+    float* velocity_x, float* velocity_y,
+    const float* acceleration_x, const float* acceleration_y,
+    const float* damping, const float* max_speed,
+    size_t count, float delta_time
+)
+{
+    const __m256 delta8 = _mm256_set1_ps(delta_time);
+    const __m256 one = _mm256_set1_ps(1.f);
+
+    size_t i = 0;
+    for (; i + 8 <= count; i += 8) {
+        const __m256 old_x = _mm256_loadu_ps(&velocity_x[i]);
+        const __m256 old_y = _mm256_loadu_ps(&velocity_y[i]);
+        const __m256 drag = _mm256_loadu_ps(&damping[i]);
+        const __m256 x = _mm256_add_ps(old_x, _mm256_mul_ps(_mm256_sub_ps(_mm256_loadu_ps(&acceleration_x[i]), _mm256_mul_ps(old_x, drag)), delta8));
+        const __m256 y = _mm256_add_ps(old_y, _mm256_mul_ps(_mm256_sub_ps(_mm256_loadu_ps(&acceleration_y[i]), _mm256_mul_ps(old_y, drag)), delta8));
+
+        const __m256 speed_squared = _mm256_add_ps(_mm256_mul_ps(x, x), _mm256_mul_ps(y, y));
+        const __m256 limit = _mm256_loadu_ps(&max_speed[i]);
+        const __m256 over = _mm256_cmp_ps(speed_squared, _mm256_mul_ps(limit, limit), _CMP_GT_OQ);
+        const __m256 scale = _mm256_blendv_ps(one, _mm256_div_ps(limit, _mm256_sqrt_ps(speed_squared)), over);
+
+        _mm256_storeu_ps(&velocity_x[i], _mm256_mul_ps(x, scale));
+        _mm256_storeu_ps(&velocity_y[i], _mm256_mul_ps(y, scale));
+    }
+    accelerateScalar(
+        velocity_x + i, velocity_y + i,
+        acceleration_x + i, acceleration_y + i,
+        damping + i, max_speed + i,
+        count - i, delta_time
+    );
+}
+
+GAME_TARGET_AVX2
+SpriteBounds boundsAVX2(const SpriteColumns& sprites, size_t first, size_t last)
+{
+    const __m256 half = _mm256_set1_ps(SPRITE_SIZE * 0.5f);
+    __m256 min_x = _mm256_set1_ps(std::numeric_limits<float>::max());
+    __m256 min_y = min_x;
+    __m256 max_x = _mm256_set1_ps(std::numeric_limits<float>::lowest());
+    __m256 max_y = max_x;
+
+    size_t i = first;
+    for (; i + 8 <= last; i += 8) {
+        const __m256 x = _mm256_loadu_ps(&sprites.x[i]);
+        const __m256 y = _mm256_loadu_ps(&sprites.y[i]);
+        const __m256 half_size = _mm256_mul_ps(_mm256_loadu_ps(&sprites.scale[i]), half);
+        min_x = _mm256_min_ps(min_x, _mm256_sub_ps(x, half_size));
+        min_y = _mm256_min_ps(min_y, _mm256_sub_ps(y, half_size));
+        max_x = _mm256_max_ps(max_x, _mm256_add_ps(x, half_size));
+        max_y = _mm256_max_ps(max_y, _mm256_add_ps(y, half_size));
+    }
+
+    SpriteBounds bounds = boundsScalar(sprites, i, last);
+    bounds.min.x = std::min({ bounds.min.x, horizontalMin(_mm256_castps256_ps128(min_x)), horizontalMin(_mm256_extractf128_ps(min_x, 1)) });
+    bounds.min.y = std::min({ bounds.min.y, horizontalMin(_mm256_castps256_ps128(min_y)), horizontalMin(_mm256_extractf128_ps(min_y, 1)) });
+    bounds.max.x = std::max({ bounds.max.x, horizontalMax(_mm256_castps256_ps128(max_x)), horizontalMax(_mm256_extractf128_ps(max_x, 1)) });
+    bounds.max.y = std::max({ bounds.max.y, horizontalMax(_mm256_castps256_ps128(max_y)), horizontalMax(_mm256_extractf128_ps(max_y, 1)) });
+    return bounds;
+}
+
+#endif
+
+const SpriteKernels SCALAR_KERNELS = { "Scalar", packScalar, integrateScalar, accelerateScalar, boundsScalar };
+#if defined(GAME_SIMD_SSE2)
+const SpriteKernels SSE2_KERNELS = { "SSE2", packSSE2, integrateSSE2, accelerateSSE2, boundsSSE2 };
+#endif
+#if defined(GAME_SIMD_AVX2)
+const SpriteKernels AVX2_KERNELS = { "AVX2", packAVX2, integrateAVX2, accelerateAVX2, boundsAVX2 };
+#endif
+
+SimdLevel detectSimdLevel()
+{
+#if defined(GAME_SIMD_AVX2)
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2")) {
+        return SimdLevel::AVX2;
+    }
+#endif
+#if defined(GAME_SIMD_SSE2)
+    return SimdLevel::SSE2;
+#else
+    return SimdLevel::Scalar;
+#endif
+}
+
+// Falls back to the next level down if the requested one wasn't compiled in
+
+const SpriteKernels& getSpriteKernels(SimdLevel level)
+{
+#if defined(GAME_SIMD_AVX2)
+    if (level == SimdLevel::AVX2) {
+        return AVX2_KERNELS;
+    }
+#endif
+#if defined(GAME_SIMD_SSE2)
+    if (level == SimdLevel::AVX2 || level == SimdLevel::SSE2) {
+        return SSE2_KERNELS;
+    }
+#endif
+    return SCALAR_KERNELS;
+}
+
+const SpriteKernels& getSpriteKernels()
+{
+    static const SpriteKernels& kernels = []() -> const SpriteKernels& {
+        const SpriteKernels& best = getSpriteKernels(detectSimdLevel());
+        Log::info("Using {} sprite kernels", best.name);
+        return best;
+    }();
+    return kernels;
+}
+
+} // namespace Engine
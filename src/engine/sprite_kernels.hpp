@@ -0,0 +1,47 @@
+#pragma once
+
+#include "sprite.hpp"
+#include <cstddef>
+#include <glm/glm.hpp>
+
+namespace Engine {
+
+// Matches the quad size in the sprite shader
+constexpr float SPRITE_SIZE = 100.f;
+
+enum class SimdLevel {
+    Scalar,
+    SSE2,
+    AVX2,
+};
+
+// Bulk operations over the sprite columns. Every level computes the same results, the
+// best one the CPU supports gets picked at runtime.
+
+struct SpriteKernels {
+    const char* name;
+
+    // Writes one instance for each sprite in [first, last) interpolated by alpha, returns
+    // whether any of them are still moving between ticks
+    bool (*pack)(const SpriteColumns& sprites, size_t first, size_t last, float alpha, SpriteInstanceData* out);
+
+    void (*integrate)(float* x, float* y, const float* velocity_x, const float* velocity_y, size_t count, float delta_time);
+
+    // Applies acceleration and damping to the velocities, then scales any faster than their
+    // max speed back down to it. Infinite max speeds never clamp.
+    void (*accelerate)(
+        float* velocity_x, float* velocity_y,
+        const float* acceleration_x, const float* acceleration_y,
+        const float* damping, const float* max_speed,
+        size_t count, float delta_time
+    );
+
+    // Bounds of every sprite quad in [first, last), which must not be empty
+    SpriteBounds (*bounds)(const SpriteColumns& sprites, size_t first, size_t last);
+};
+
+SimdLevel detectSimdLevel();
+const SpriteKernels& getSpriteKernels(SimdLevel level);
+const SpriteKernels& getSpriteKernels();
+
+} // namespace Engine
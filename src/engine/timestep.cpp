@@ -0,0 +1,58 @@
+#include <pch.hpp>
+
+#include "timestep.hpp"
+#include <algorithm>
+
+namespace Engine {
+
+void FixedTimestep::setTickRate(float tick_rate)
+{
+    if (tick_rate <= 0.f) {
+        Log::warn("Ignoring invalid tick rate {}", tick_rate);
+        return;
+    }
+    this->tick_rate = tick_rate;
+    step_size = 1.f / tick_rate;
+}
+
+float FixedTimestep::getTickRate() const
+{
+    return tick_rate;
+}
+
+float FixedTimestep::getStep() const
+{
+    return step_size;
+}
+
+void FixedTimestep::setMaxCatchUp(size_t max_steps)
+{
+    max_catch_up = std::max<size_t>(max_steps, 1);
+}
+
+void FixedTimestep::advance(float delta_time)
+{
+    accumulator += delta_time;
+
+    const float max_accumulated = step_size * static_cast<float>(max_catch_up);
+    if (accumulator > max_accumulated) {
+        Log::debug("Dropping {:.3f}s of simulation time to catch up", accumulator - max_accumulated);
+        accumulator = max_accumulated;
+    }
+}
+
+bool FixedTimestep::step()
+{
+    if (accumulator < step_size) {
+        return false;
+    }
+    accumulator -= step_size;
+    return true;
+}
+
+float FixedTimestep::getAlpha() const
+{
+    return std::clamp(accumulator / step_size, 0.f, 1.f);
+}
+
+} // namespace Engine
@@ -0,0 +1,34 @@
+#pragma once
+
+#include <cstddef>
+
+namespace Engine {
+
+// Accumulates variable frame time and hands it out in fixed sized ticks so that
+// the simulation runs at the same rate regardless of how fast we are rendering
+
+class FixedTimestep {
+public:
+    constexpr static float DEFAULT_TICK_RATE = 60.f;
+    constexpr static size_t DEFAULT_MAX_CATCH_UP = 5;
+
+    void setTickRate(float tick_rate);
+    float getTickRate() const;
+    float getStep() const;
+
+    // Caps how many ticks can run in a single frame, anything past that is dropped so
+    // a slow frame can't snowball into even slower frames
+    void setMaxCatchUp(size_t max_steps);
+
+    void advance(float delta_time);
+    bool step();
+    float getAlpha() const;
+
+private:
+    float tick_rate = DEFAULT_TICK_RATE;
+    float step_size = 1.f / DEFAULT_TICK_RATE;
+    size_t max_catch_up = DEFAULT_MAX_CATCH_UP;
+    float accumulator = 0.f;
+};
+
+} // namespace Engine
@@ -0,0 +1,146 @@
+#include <pch.hpp>
+
+#include "ui_input.hpp"
+#include <cfloat>
+#include <imgui.h>
+
+namespace Engine {
+
+static ImGuiKey toImGuiKey(SDL_Keycode key)
+{
+    if (key >= SDLK_a && key <= SDLK_z) {
+        return static_cast<ImGuiKey>(ImGuiKey_A + (key - SDLK_a));
+    }
+    if (key >= SDLK_0 && key <= SDLK_9) {
+        return static_cast<ImGuiKey>(ImGuiKey_0 + (key - SDLK_0));
+    }
+    if (key >= SDLK_F1 && key <= SDLK_F12) {
+        return static_cast<ImGuiKey>(ImGuiKey_F1 + (key - SDLK_F1));
+    }
+    if (key >= SDLK_KP_1 && key <= SDLK_KP_9) {
+        return static_cast<ImGuiKey>(ImGuiKey_Keypad1 + (key - SDLK_KP_1));
+    }
+
+    switch (key) {
+    case SDLK_TAB: return ImGuiKey_Tab;
+    case SDLK_LEFT: return ImGuiKey_LeftArrow;
+    case SDLK_RIGHT: return ImGuiKey_RightArrow;
+    case SDLK_UP: return ImGuiKey_UpArrow;
+    case SDLK_DOWN: return ImGuiKey_DownArrow;
+    case SDLK_PAGEUP: return ImGuiKey_PageUp;
+    case SDLK_PAGEDOWN: return ImGuiKey_PageDown;
+    case SDLK_HOME: return ImGuiKey_Home;
+    case SDLK_END: return ImGuiKey_End;
+    case SDLK_INSERT: return ImGuiKey_Insert;
+    case SDLK_DELETE: return ImGuiKey_Delete;
+    case SDLK_BACKSPACE: return ImGuiKey_Backspace;
+    case SDLK_SPACE: return ImGuiKey_Space;
+    case SDLK_RETURN: return ImGuiKey_Enter;
+    case SDLK_ESCAPE: return ImGuiKey_Escape;
+    case SDLK_QUOTE: return ImGuiKey_Apostrophe;
+    case SDLK_COMMA: return ImGuiKey_Comma;
+    case SDLK_MINUS: return ImGuiKey_Minus;
+    case SDLK_PERIOD: return ImGuiKey_Period;
+    case SDLK_SLASH: return ImGuiKey_Slash;
+    case SDLK_SEMICOLON: return ImGuiKey_Semicolon;
+    case SDLK_EQUALS: return ImGuiKey_Equal;
+    case SDLK_LEFTBRACKET: return ImGuiKey_LeftBracket;
+    case SDLK_BACKSLASH: return ImGuiKey_Backslash;
+    case SDLK_RIGHTBRACKET: return ImGuiKey_RightBracket;
+    case SDLK_BACKQUOTE: return ImGuiKey_GraveAccent;
+    case SDLK_CAPSLOCK: return ImGuiKey_CapsLock;
+    case SDLK_SCROLLLOCK: return ImGuiKey_ScrollLock;
+    case SDLK_NUMLOCKCLEAR: return ImGuiKey_NumLock;
+    case SDLK_PRINTSCREEN: return ImGuiKey_PrintScreen;
+    case SDLK_PAUSE: return ImGuiKey_Pause;
+    case SDLK_KP_0: return ImGuiKey_Keypad0;
+    case SDLK_KP_PERIOD: return ImGuiKey_KeypadDecimal;
+    case SDLK_KP_DIVIDE: return ImGuiKey_KeypadDivide;
+    case SDLK_KP_MULTIPLY: return ImGuiKey_KeypadMultiply;
+    case SDLK_KP_MINUS: return ImGuiKey_KeypadSubtract;
+    case SDLK_KP_PLUS: return ImGuiKey_KeypadAdd;
+    case SDLK_KP_ENTER: return ImGuiKey_KeypadEnter;
+    case SDLK_KP_EQUALS: return ImGuiKey_KeypadEqual;
+    case SDLK_LCTRL: return ImGuiKey_LeftCtrl;
+    case SDLK_LSHIFT: return ImGuiKey_LeftShift;
+    case SDLK_LALT: return ImGuiKey_LeftAlt;
+    case SDLK_LGUI: return ImGuiKey_LeftSuper;
+    case SDLK_RCTRL: return ImGuiKey_RightCtrl;
+    case SDLK_RSHIFT: return ImGuiKey_RightShift;
+    case SDLK_RALT: return ImGuiKey_RightAlt;
+    case SDLK_RGUI: return ImGuiKey_RightSuper;
+    case SDLK_APPLICATION: return ImGuiKey_Menu;
+    default: return ImGuiKey_None;
+    }
+}
+
+// Same translation the SDL backend does, only from data copied out of the events
+
+static void applyEvent(ImGuiIO& io, const SDL_Event& event)
+{
+    switch (event.type) {
+    case SDL_MOUSEMOTION:
+        io.AddMousePosEvent(static_cast<float>(event.motion.x), static_cast<float>(event.motion.y));
+        break;
+    case SDL_MOUSEWHEEL:
+        io.AddMouseWheelEvent(-static_cast<float>(event.wheel.x), static_cast<float>(event.wheel.y));
+        break;
+    case SDL_MOUSEBUTTONDOWN:
+    case SDL_MOUSEBUTTONUP: {
+        int button = -1;
+        switch (event.button.button) {
+        case SDL_BUTTON_LEFT: button = 0; break;
+        case SDL_BUTTON_RIGHT: button = 1; break;
+        case SDL_BUTTON_MIDDLE: button = 2; break;
+        case SDL_BUTTON_X1: button = 3; break;
+        case SDL_BUTTON_X2: button = 4; break;
+        default: break;
+        }
+        if (button != -1) {
+            io.AddMouseButtonEvent(button, event.type == SDL_MOUSEBUTTONDOWN);
+        }
+        break;
+    }
+    case SDL_TEXTINPUT:
+        io.AddInputCharactersUTF8(event.text.text);
+        break;
+    case SDL_KEYDOWN:
+    case SDL_KEYUP: {
+        const Uint16 modifiers = event.key.keysym.mod;
+        io.AddKeyEvent(ImGuiMod_Ctrl, (modifiers & KMOD_CTRL) != 0);
+        io.AddKeyEvent(ImGuiMod_Shift, (modifiers & KMOD_SHIFT) != 0);
+        io.AddKeyEvent(ImGuiMod_Alt, (modifiers & KMOD_ALT) != 0);
+        io.AddKeyEvent(ImGuiMod_Super, (modifiers & KMOD_GUI) != 0);
+        const ImGuiKey key = toImGuiKey(event.key.keysym.sym);
+        if (key != ImGuiKey_None) {
+            io.AddKeyEvent(key, event.type == SDL_KEYDOWN);
+        }
+        break;
+    }
+    case SDL_WINDOWEVENT:
+        if (event.window.event == SDL_WINDOWEVENT_LEAVE) {
+            io.AddMousePosEvent(-FLT_MAX, -FLT_MAX);
+        } else if (event.window.event == SDL_WINDOWEVENT_FOCUS_GAINED) {
+            io.AddFocusEvent(true);
+        } else if (event.window.event == SDL_WINDOWEVENT_FOCUS_LOST) {
+            io.AddFocusEvent(false);
+        }
+        break;
+    default: break;
+    }
+}
+
+void applyUiInput(const UiInput& input, float delta_time)
+{
+    ImGuiIO& io = ImGui::GetIO();
+    io.DisplaySize = ImVec2(input.display_size.x, input.display_size.y);
+    io.DisplayFramebufferScale = ImVec2(input.framebuffer_scale.x, input.framebuffer_scale.y);
+    // ImGui refuses a zero delta, which the first frame and a paused replay can have
+    io.DeltaTime = delta_time > 0.f ? delta_time : 1.f / 60.f;
+
+    for (const SDL_Event& event : input.events) {
+        applyEvent(io, event);
+    }
+}
+
+} // namespace Engine
@@ -0,0 +1,22 @@
+#pragma once
+
+#include <SDL.h>
+#include <vector>
+#include <glm/glm.hpp>
+
+namespace Engine {
+
+// What ImGui needs from SDL for one frame. SDL's window and input state can only be read on
+// the main thread while ImGui runs on the render thread, so the simulation thread fills
+// this in and the render thread feeds it to ImGui, taking the place of the SDL backend.
+
+struct UiInput {
+    glm::vec2 display_size = glm::vec2(0.f, 0.f);
+    glm::vec2 framebuffer_scale = glm::vec2(1.f, 1.f);
+    std::vector<SDL_Event> events;
+};
+
+// Render thread only, right before ImGui::NewFrame
+void applyUiInput(const UiInput& input, float delta_time);
+
+} // namespace Engine
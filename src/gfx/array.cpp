@@ -2,6 +2,7 @@
 
 #include "array.hpp"
 #include "opengl.hpp"
+#include "gl_state.hpp"
 #include "gfx/buffer.hpp"
 
 namespace Engine {
@@ -13,10 +14,10 @@ VertexArray::VertexArray()
 
 VertexArray::~VertexArray()
 {
-    OPENGL_CALL(glDeleteVertexArrays(1, &vao));
+    GL_STATE.deleteVertexArray(vao);
 }
 
-void VertexArray::addBuffer(const VertexBuffer& buffer, const VertexBufferLayout& layout)
+void VertexArray::addBuffer(const VertexBuffer& buffer, const VertexBufferLayout& layout, AttributeRate rate)
 {
     bind();
     buffer.bind();
@@ -26,7 +27,7 @@ void VertexArray::addBuffer(const VertexBuffer& buffer, const VertexBufferLayout
 
     for (size_t i = 0; i < attribs.size(); i++) {
         const auto& attrib = attribs[i];
-        Log::debug("Attrib pointer call, index {} count {} type {} stride {} offset {}",
+        Log::debug(Log::Category::Render, "Attrib pointer call, index {} count {} type {} stride {} offset {}",
             i, attrib.getCount(), static_cast<GLenum>(attrib.getType()), layout.getStride(), offset
         );
         if (attrib.getType() == AttributeType::UInt || attrib.getType() == AttributeType::Int) {
@@ -48,18 +49,26 @@ void VertexArray::addBuffer(const VertexBuffer& buffer, const VertexBufferLayout
             ));
         }
         OPENGL_CALL(glEnableVertexAttribArray(static_cast<GLuint>(i)));
+        if (rate == AttributeRate::PerInstance) {
+            OPENGL_CALL(glVertexAttribDivisor(static_cast<GLuint>(i), 1));
+        }
         offset += attrib.getCount() * AttributeDescriptor::getTypeSize(attrib.getType());
     }
 }
 
 void VertexArray::bind() const
 {
-    OPENGL_CALL(glBindVertexArray(vao));
+    GL_STATE.bindVertexArray(vao);
 }
 
 void VertexArray::unbind() const
 {
-    OPENGL_CALL(glBindVertexArray(0));
+    GL_STATE.bindVertexArray(0);
+}
+
+unsigned int VertexArray::getHandle() const
+{
+    return vao;
 }
 
 } // namespace Engine
@@ -12,9 +12,10 @@ public:
     DELETE_COPY(VertexArray);
     DEFAULT_MOVE(VertexArray);
 
-    void addBuffer(const VertexBuffer& buffer, const VertexBufferLayout& layout);
+    void addBuffer(const VertexBuffer& buffer, const VertexBufferLayout& layout, AttributeRate rate = AttributeRate::PerVertex);
     void bind() const;
     void unbind() const;
+    unsigned int getHandle() const;
 
 private:
     unsigned int vao;
@@ -2,6 +2,7 @@
 
 #include "buffer.hpp"
 #include "opengl.hpp"
+#include "gl_state.hpp"
 
 namespace Engine {
 
@@ -12,7 +13,7 @@ VertexBuffer::VertexBuffer()
 
 VertexBuffer::~VertexBuffer()
 {
-    OPENGL_CALL(glDeleteBuffers(1, &vbo));
+    GL_STATE.deleteBuffer(vbo);
 }
 
 void VertexBuffer::buffer(const void* data, size_t size)
@@ -24,12 +25,12 @@ void VertexBuffer::buffer(const void* data, size_t size)
 
 void VertexBuffer::bind() const
 {
-    OPENGL_CALL(glBindBuffer(GL_ARRAY_BUFFER, vbo));
+    GL_STATE.bindArrayBuffer(vbo);
 }
 
 void VertexBuffer::unbind() const
 {
-    OPENGL_CALL(glBindBuffer(GL_ARRAY_BUFFER, 0));
+    GL_STATE.bindArrayBuffer(0);
 }
 
 bool VertexBuffer::isEmpty() const
@@ -30,9 +30,16 @@ enum class AttributeType : GLenum {
     Float = GL_FLOAT,
     Vec2 = GL_FLOAT_VEC2,
     Vec3 = GL_FLOAT_VEC3,
+    Vec4 = GL_FLOAT_VEC4,
     Mat4 = GL_FLOAT_MAT4,
 };
 
+// Whether an attribute advances per vertex or once per instance
+enum class AttributeRate {
+    PerVertex,
+    PerInstance,
+};
+
 struct AttributeDescriptor { 
     AttributeDescriptor(AttributeType type, size_t count)
         : type(type), count(count) {}
@@ -45,6 +52,7 @@ struct AttributeDescriptor {
         case AttributeType::Float:
         case AttributeType::Vec2: 
         case AttributeType::Vec3: 
+        case AttributeType::Vec4: 
         case AttributeType::Mat4: return AttributeType::Float;
         default: return AttributeType::Float;
         }
@@ -58,6 +66,7 @@ struct AttributeDescriptor {
         case AttributeType::Float: return count;
         case AttributeType::Vec2: return count * 2;
         case AttributeType::Vec3: return count * 3;
+        case AttributeType::Vec4: return count * 4;
         case AttributeType::Mat4: return count * 16;
         default: return 0;
         }
@@ -71,6 +80,7 @@ struct AttributeDescriptor {
         case AttributeType::Float: return sizeof(GLfloat);
         case AttributeType::Vec2: return sizeof(GLfloat) * 2;
         case AttributeType::Vec3: return sizeof(GLfloat) * 3;
+        case AttributeType::Vec4: return sizeof(GLfloat) * 4;
         case AttributeType::Mat4: return sizeof(GLfloat) * 16;
         default: return 0;
         }
@@ -124,6 +134,12 @@ inline void VertexBufferLayout::push<glm::vec3>(size_t count) {
     stride += sizeof(GLfloat) * 3 * count;
 }
 
+template <>
+inline void VertexBufferLayout::push<glm::vec4>(size_t count) {
+    attributes.push_back(AttributeDescriptor(AttributeType::Vec4, count));
+    stride += sizeof(GLfloat) * 4 * count;
+}
+
 template <>
 inline void VertexBufferLayout::push<glm::mat4>(size_t count) {
     attributes.push_back(AttributeDescriptor(AttributeType::Mat4, count));
@@ -0,0 +1,200 @@
+#include <pch.hpp>
+
+#include "gl_state.hpp"
+#include "opengl.hpp"
+
+namespace Engine {
+
+GLState GL_STATE;
+
+GLState::GLState()
+{
+    invalidate();
+}
+
+bool GLState::changed(unsigned int& cached, unsigned int value)
+{
+    if (cached == value) {
+        avoided++;
+        return false;
+    }
+    cached = value;
+    issued++;
+    return true;
+}
+
+size_t GLState::targetIndex(unsigned int target)
+{
+    switch (target) {
+    case GL_TEXTURE_2D: return 0;
+    case GL_TEXTURE_2D_ARRAY: return 1;
+    default: return TEXTURE_TARGETS;
+    }
+}
+
+bool GLState::bindVertexArray(unsigned int vertex_array)
+{
+    if (!changed(this->vertex_array, vertex_array)) {
+        return false;
+    }
+    OPENGL_CALL(glBindVertexArray(vertex_array));
+    return true;
+}
+
+bool GLState::bindArrayBuffer(unsigned int buffer)
+{
+    if (!changed(array_buffer, buffer)) {
+        return false;
+    }
+    OPENGL_CALL(glBindBuffer(GL_ARRAY_BUFFER, buffer));
+    return true;
+}
+
+bool GLState::useProgram(unsigned int program)
+{
+    if (!changed(this->program, program)) {
+        return false;
+    }
+    OPENGL_CALL(glUseProgram(program));
+    return true;
+}
+
+bool GLState::setActiveTexture(unsigned int unit)
+{
+    if (!changed(active_texture, unit)) {
+        return false;
+    }
+    OPENGL_CALL(glActiveTexture(GL_TEXTURE0 + unit));
+    return true;
+}
+
+bool GLState::bindTexture(unsigned int target, unsigned int texture)
+{
+    const size_t index = targetIndex(target);
+    if (active_texture >= MAX_TEXTURE_UNITS || index == TEXTURE_TARGETS) {
+        issued++;
+        OPENGL_CALL(glBindTexture(target, texture));
+        return true;
+    }
+    if (!changed(textures[active_texture][index], texture)) {
+        return false;
+    }
+    OPENGL_CALL(glBindTexture(target, texture));
+    return true;
+}
+
+bool GLState::bindTexture(unsigned int unit, unsigned int target, unsigned int texture)
+{
+    // Only switch units when the bind itself is needed
+    const size_t index = targetIndex(target);
+    if (unit < MAX_TEXTURE_UNITS && index != TEXTURE_TARGETS && textures[unit][index] == texture) {
+        avoided++;
+        return false;
+    }
+    setActiveTexture(unit);
+    return bindTexture(target, texture);
+}
+
+bool GLState::setBlend(bool enabled)
+{
+    if (!changed(blend, enabled ? 1 : 0)) {
+        return false;
+    }
+    if (enabled) {
+        OPENGL_CALL(glEnable(GL_BLEND));
+    } else {
+        OPENGL_CALL(glDisable(GL_BLEND));
+    }
+    return true;
+}
+
+bool GLState::setBlendFunc(unsigned int source, unsigned int destination)
+{
+    if (blend_source == source && blend_destination == destination) {
+        avoided++;
+        return false;
+    }
+    blend_source = source;
+    blend_destination = destination;
+    issued++;
+    OPENGL_CALL(glBlendFunc(source, destination));
+    return true;
+}
+
+bool GLState::setPolygonMode(unsigned int mode)
+{
+    if (!changed(polygon_mode, mode)) {
+        return false;
+    }
+    OPENGL_CALL(glPolygonMode(GL_FRONT_AND_BACK, mode));
+    return true;
+}
+
+void GLState::deleteVertexArray(unsigned int vertex_array)
+{
+    if (this->vertex_array == vertex_array) {
+        this->vertex_array = UNKNOWN;
+    }
+    OPENGL_CALL(glDeleteVertexArrays(1, &vertex_array));
+}
+
+void GLState::deleteBuffer(unsigned int buffer)
+{
+    if (array_buffer == buffer) {
+        array_buffer = UNKNOWN;
+    }
+    OPENGL_CALL(glDeleteBuffers(1, &buffer));
+}
+
+void GLState::deleteProgram(unsigned int program)
+{
+    if (this->program == program) {
+        this->program = UNKNOWN;
+    }
+    OPENGL_CALL(glDeleteProgram(program));
+}
+
+void GLState::deleteTexture(unsigned int texture)
+{
+    for (auto& unit : textures) {
+        for (unsigned int& bound : unit) {
+            if (bound == texture) {
+                bound = UNKNOWN;
+            }
+        }
+    }
+    OPENGL_CALL(glDeleteTextures(1, &texture));
+}
+
+void GLState::invalidate()
+{
+    vertex_array = UNKNOWN;
+    array_buffer = UNKNOWN;
+    program = UNKNOWN;
+    active_texture = UNKNOWN;
+    for (auto& unit : textures) {
+        unit.fill(UNKNOWN);
+    }
+    blend = UNKNOWN;
+    blend_source = UNKNOWN;
+    blend_destination = UNKNOWN;
+    polygon_mode = UNKNOWN;
+}
+
+uint64_t GLState::getIssuedCount() const
+{
+    return issued;
+}
+
+uint64_t GLState::getAvoidedCount() const
+{
+    return avoided;
+}
+
+void GLState::resetCounters()
+{
+    issued = 0;
+    avoided = 0;
+}
+
+} // namespace Engine
@@ -0,0 +1,75 @@
+#pragma once
+
+#include "../constructors.hpp"
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+
+namespace Engine {
+
+// Remembers what is bound on the GL context and drops binds and state changes that
+// wouldn't change anything. Every bind in gfx/ and resource/ goes through here, code that
+// calls GL directly has to put things back the way it found them (ImGui does) or call
+// invalidate afterwards.
+//
+// There is one context and only the thread currently holding it touches GL, so there is
+// one global cache and no locking. The calls return whether GL was actually called.
+
+class GLState {
+public:
+    constexpr static size_t MAX_TEXTURE_UNITS = 16;
+
+    GLState();
+    DELETE_COPY(GLState);
+    DELETE_MOVE(GLState);
+
+    bool bindVertexArray(unsigned int vertex_array);
+    bool bindArrayBuffer(unsigned int buffer);
+    bool useProgram(unsigned int program);
+    bool setActiveTexture(unsigned int unit);
+    // Binds to the active unit
+    bool bindTexture(unsigned int target, unsigned int texture);
+    bool bindTexture(unsigned int unit, unsigned int target, unsigned int texture);
+    bool setBlend(bool enabled);
+    bool setBlendFunc(unsigned int source, unsigned int destination);
+    bool setPolygonMode(unsigned int mode);
+
+    // Deleting a bound object unbinds it, these keep the cache in step
+    void deleteVertexArray(unsigned int vertex_array);
+    void deleteBuffer(unsigned int buffer);
+    void deleteProgram(unsigned int program);
+    void deleteTexture(unsigned int texture);
+
+    // Forgets everything, the next call of each kind always goes through
+    void invalidate();
+
+    uint64_t getIssuedCount() const;
+    uint64_t getAvoidedCount() const;
+    void resetCounters();
+
+private:
+    constexpr static unsigned int UNKNOWN = std::numeric_limits<unsigned int>::max();
+    // Only the targets the engine binds are cached, anything else always goes through
+    constexpr static size_t TEXTURE_TARGETS = 2;
+
+    bool changed(unsigned int& cached, unsigned int value);
+    static size_t targetIndex(unsigned int target);
+
+    unsigned int vertex_array;
+    unsigned int array_buffer;
+    unsigned int program;
+    unsigned int active_texture;
+    std::array<std::array<unsigned int, TEXTURE_TARGETS>, MAX_TEXTURE_UNITS> textures;
+    unsigned int blend;
+    unsigned int blend_source;
+    unsigned int blend_destination;
+    unsigned int polygon_mode;
+
+    uint64_t issued = 0;
+    uint64_t avoided = 0;
+};
+
+extern GLState GL_STATE;
+
+} // namespace Engine
@@ -0,0 +1,150 @@
+#include <pch.hpp>
+
+#include "gpu_timer.hpp"
+#include "opengl.hpp"
+
+namespace Engine {
+
+// Queries aren't worth crashing over so nothing in here goes through OPENGL_CALL, any
+// error just turns the timer off
+
+GpuTimer::GpuTimer()
+{
+    const GLubyte* renderer = glGetString(GL_RENDERER);
+    renderer_name = renderer != nullptr ? reinterpret_cast<const char*>(renderer) : "unknown";
+    software = renderer_name.find("llvmpipe") != std::string::npos
+        || renderer_name.find("softpipe") != std::string::npos
+        || renderer_name.find("SwiftShader") != std::string::npos;
+
+    if (!GLAD_GL_VERSION_3_3 && !GLAD_GL_ARB_timer_query) {
+        Log::warn(Log::Category::Render, "Timer queries not available on {}, GPU timing disabled", renderer_name);
+        return;
+    }
+
+    GLint timestamp_bits = 0;
+    glGetQueryiv(GL_TIMESTAMP, GL_QUERY_COUNTER_BITS, &timestamp_bits);
+    if (timestamp_bits == 0) {
+        Log::warn(Log::Category::Render, "{} has no timestamp counter, GPU timing disabled", renderer_name);
+        glGetError();
+        return;
+    }
+
+    for (auto& slot : slots) {
+        glGenQueries(static_cast<GLsizei>(slot.queries.size()), slot.queries.data());
+    }
+    if (glGetError() != GL_NO_ERROR) {
+        Log::warn(Log::Category::Render, "Failed to create timer queries, GPU timing disabled");
+        return;
+    }
+
+    supported = true;
+    if (software) {
+        Log::info(Log::Category::Render, "GPU timing on software renderer {}", renderer_name);
+    }
+}
+
+GpuTimer::~GpuTimer()
+{
+    if (!supported) {
+        return;
+    }
+    for (auto& slot : slots) {
+        glDeleteQueries(static_cast<GLsizei>(slot.queries.size()), slot.queries.data());
+    }
+}
+
+bool GpuTimer::isSupported() const
+{
+    return supported;
+}
+
+bool GpuTimer::isSoftware() const
+{
+    return software;
+}
+
+const std::string& GpuTimer::getRendererName() const
+{
+    return renderer_name;
+}
+
+void GpuTimer::beginFrame()
+{
+    if (!supported) {
+        return;
+    }
+
+    // Pick up every frame the GPU finished since last time, oldest first
+    for (size_t i = 0; i < FRAME_LATENCY; i++) {
+        Slot& slot = slots[(frame_count + i) % FRAME_LATENCY];
+        if (slot.pending) {
+            collect(slot);
+        }
+    }
+
+    current = &slots[frame_count % FRAME_LATENCY];
+    if (current->pending) {
+        // Still not done after FRAME_LATENCY frames, overwrite it instead of stalling
+        current->pending = false;
+        skipped++;
+    }
+    current->frame = frame_count++;
+    current->mark_count = 0;
+    glQueryCounter(current->queries[0], GL_TIMESTAMP);
+}
+
+void GpuTimer::mark(const char* name)
+{
+    if (current == nullptr || current->mark_count == MAX_SECTIONS) {
+        return;
+    }
+    current->names[current->mark_count] = name;
+    current->mark_count++;
+    glQueryCounter(current->queries[current->mark_count], GL_TIMESTAMP);
+}
+
+void GpuTimer::endFrame()
+{
+    if (current == nullptr) {
+        return;
+    }
+    current->pending = current->mark_count > 0;
+    current = nullptr;
+}
+
+void GpuTimer::collect(Slot& slot)
+{
+    // Timestamps complete in order so the last one being ready means they all are
+    GLint available = 0;
+    glGetQueryObjectiv(slot.queries[slot.mark_count], GL_QUERY_RESULT_AVAILABLE, &available);
+    if (!available) {
+        return;
+    }
+    slot.pending = false;
+
+    std::array<GLuint64, MAX_SECTIONS + 1> timestamps {};
+    for (size_t i = 0; i <= slot.mark_count; i++) {
+        glGetQueryObjectui64v(slot.queries[i], GL_QUERY_RESULT, &timestamps[i]);
+    }
+
+    FrameTiming timing;
+    timing.frame = slot.frame;
+    timing.section_count = slot.mark_count;
+    for (size_t i = 0; i < slot.mark_count; i++) {
+        timing.sections[i] = { slot.names[i], (timestamps[i + 1] - timestamps[i]) / 1e6f };
+    }
+    timing.total_milliseconds = (timestamps[slot.mark_count] - timestamps[0]) / 1e6f;
+    latest = timing;
+}
+
+const std::optional<GpuTimer::FrameTiming>& GpuTimer::getLatest() const
+{
+    return latest;
+}
+
+size_t GpuTimer::getSkippedCount() const
+{
+    return skipped;
+}
+
+} // namespace Engine
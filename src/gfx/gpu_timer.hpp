@@ -0,0 +1,74 @@
+#pragma once
+
+#include "../constructors.hpp"
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <string>
+
+namespace Engine {
+
+// Times sections of a frame on the GPU with timestamp queries. Results are read back a few
+// frames later once the GPU is done with them so the CPU never waits on a query. All calls
+// have to come from the thread that owns the GL context.
+
+class GpuTimer {
+public:
+    constexpr static size_t FRAME_LATENCY = 4;
+    constexpr static size_t MAX_SECTIONS = 8;
+
+    struct Section {
+        const char* name = nullptr;
+        float milliseconds = 0.f;
+    };
+
+    struct FrameTiming {
+        uint64_t frame = 0;
+        float total_milliseconds = 0.f;
+        size_t section_count = 0;
+        std::array<Section, MAX_SECTIONS> sections;
+    };
+
+    GpuTimer();
+    ~GpuTimer();
+    DELETE_COPY(GpuTimer);
+    DELETE_MOVE(GpuTimer);
+
+    bool isSupported() const;
+    // Software rasterizers like llvmpipe run the "GPU" work on the CPU so the numbers
+    // only say how long rasterizing took there
+    bool isSoftware() const;
+    const std::string& getRendererName() const;
+
+    void beginFrame();
+    // Ends the section that started at the previous mark, or at beginFrame
+    void mark(const char* name);
+    void endFrame();
+
+    // Most recent frame the GPU has finished, lags FRAME_LATENCY frames behind
+    const std::optional<FrameTiming>& getLatest() const;
+    size_t getSkippedCount() const;
+
+private:
+    struct Slot {
+        std::array<unsigned int, MAX_SECTIONS + 1> queries {};
+        std::array<const char*, MAX_SECTIONS> names {};
+        size_t mark_count = 0;
+        uint64_t frame = 0;
+        bool pending = false;
+    };
+
+    void collect(Slot& slot);
+
+    bool supported = false;
+    bool software = false;
+    std::string renderer_name;
+    std::array<Slot, FRAME_LATENCY> slots;
+    Slot* current = nullptr;
+    uint64_t frame_count = 0;
+    size_t skipped = 0;
+    std::optional<FrameTiming> latest;
+};
+
+} // namespace Engine
@@ -6,7 +6,7 @@
 #define OPENGL_CALL(call) \
     call; \
     if (glGetError() != GL_NO_ERROR) { \
-        Log::error("OpenGL call failed: {}", #call); \
+        Log::error(Log::Category::Render, "OpenGL call failed: {}", #call); \
         std::exit(EXIT_FAILURE); \
     } \
     do {} while(0)
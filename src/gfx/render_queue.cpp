@@ -0,0 +1,160 @@
+#include <pch.hpp>
+
+#include "render_queue.hpp"
+#include "opengl.hpp"
+#include "gl_state.hpp"
+#include "../engine/profiler.hpp"
+#include <array>
+#include <bit>
+
+namespace Engine {
+
+constexpr static unsigned int SHADER_BITS = 12;
+constexpr static unsigned int TEXTURE_BITS = 12;
+constexpr static unsigned int DEPTH_BITS = 32;
+constexpr static size_t RADIX_BITS = 8;
+constexpr static size_t RADIX_BUCKETS = size_t { 1 } << RADIX_BITS;
+
+// Flips the float bits so they compare the same way as unsigned integers, negatives get
+// all their bits flipped since larger magnitudes have to come first
+
+static uint32_t sortableDepth(float depth)
+{
+    const uint32_t bits = std::bit_cast<uint32_t>(depth);
+    return (bits & 0x80000000u) ? ~bits : bits | 0x80000000u;
+}
+
+SortKey makeSortKey(const SortKeyFields& fields)
+{
+    constexpr SortKey shader_mask = (SortKey { 1 } << SHADER_BITS) - 1;
+    constexpr SortKey texture_mask = (SortKey { 1 } << TEXTURE_BITS) - 1;
+
+    return SortKey { fields.layer } << (SHADER_BITS + TEXTURE_BITS + DEPTH_BITS)
+        | (SortKey { fields.shader } & shader_mask) << (TEXTURE_BITS + DEPTH_BITS)
+        | (SortKey { fields.texture } & texture_mask) << DEPTH_BITS
+        | SortKey { sortableDepth(fields.depth) };
+}
+
+size_t RenderQueue::Stats::getStateChanges() const
+{
+    return program_binds + texture_binds + vertex_array_binds;
+}
+
+void RenderQueue::submit(const DrawCommand& command)
+{
+    commands.push_back(command);
+}
+
+// LSD radix sort, a byte at a time. Most frames only use a few distinct layers, shaders
+// and textures so the passes over bytes every key shares are skipped.
+
+void RenderQueue::sort()
+{
+    PROFILE_SCOPE("RenderQueue::sort");
+
+    const size_t count = commands.size();
+    if (count < 2) {
+        return;
+    }
+
+    entries.resize(count);
+    scratch.resize(count);
+    for (size_t i = 0; i < count; i++) {
+        entries[i] = Entry { commands[i].key, static_cast<uint32_t>(i) };
+    }
+
+    for (size_t shift = 0; shift < sizeof(SortKey) * 8; shift += RADIX_BITS) {
+        std::array<size_t, RADIX_BUCKETS> offsets {};
+        for (const Entry& entry : entries) {
+            offsets[(entry.key >> shift) & (RADIX_BUCKETS - 1)]++;
+        }
+        if (offsets[(entries.front().key >> shift) & (RADIX_BUCKETS - 1)] == count) {
+            continue;
+        }
+
+        size_t total = 0;
+        for (size_t& offset : offsets) {
+            const size_t bucket_size = offset;
+            offset = total;
+            total += bucket_size;
+        }
+        for (const Entry& entry : entries) {
+            scratch[offsets[(entry.key >> shift) & (RADIX_BUCKETS - 1)]++] = entry;
+        }
+        entries.swap(scratch);
+    }
+
+    sorted.resize(count);
+    for (size_t i = 0; i < count; i++) {
+        sorted[i] = commands[entries[i].index];
+    }
+    commands.swap(sorted);
+}
+
+void RenderQueue::flush()
+{
+    PROFILE_SCOPE("RenderQueue::flush");
+
+    sort();
+    execute();
+    clear();
+}
+
+void RenderQueue::clear()
+{
+    commands.clear();
+}
+
+// The GL state cache knows what is already bound, including whatever the last flush left
+// behind, the queue only counts what it let through
+
+void RenderQueue::execute()
+{
+    stats = Stats {};
+
+    for (const DrawCommand& command : commands) {
+        if (GL_STATE.useProgram(command.program)) {
+            stats.program_binds++;
+        } else {
+            stats.elided_binds++;
+        }
+
+        if (command.texture != 0) {
+            if (GL_STATE.bindTexture(command.texture_unit, command.texture_target, command.texture)) {
+                stats.texture_binds++;
+            } else {
+                stats.elided_binds++;
+            }
+        }
+
+        if (GL_STATE.bindVertexArray(command.vertex_array)) {
+            stats.vertex_array_binds++;
+        } else {
+            stats.elided_binds++;
+        }
+
+        if (command.instance_count > 0) {
+            OPENGL_CALL(glDrawArraysInstanced(command.primitive, command.first, command.count, command.instance_count));
+        } else {
+            OPENGL_CALL(glDrawArrays(command.primitive, command.first, command.count));
+        }
+        stats.draw_calls++;
+    }
+}
+
+size_t RenderQueue::size() const
+{
+    return commands.size();
+}
+
+const std::vector<DrawCommand>& RenderQueue::getCommands() const
+{
+    return commands;
+}
+
+const RenderQueue::Stats& RenderQueue::getStats() const
+{
+    return stats;
+}
+
+} // namespace Engine
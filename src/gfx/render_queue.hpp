@@ -0,0 +1,94 @@
+#pragma once
+
+#include "../constructors.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace Engine {
+
+// Draws are ordered by a 64 bit key, most significant field first:
+//   layer (8) | shader (12) | texture (12) | depth (32)
+// so everything on a layer is grouped by shader, then by texture, then drawn front to back
+// by depth. Shader and texture ids only decide grouping, the command carries the real GL
+// objects, so two that collide in their 12 bits just batch a little worse.
+
+using SortKey = uint64_t;
+
+struct SortKeyFields {
+    uint8_t layer = 0;
+    unsigned int shader = 0;
+    unsigned int texture = 0;
+    float depth = 0.f;
+};
+
+SortKey makeSortKey(const SortKeyFields& fields);
+
+// Everything needed to issue one draw. A texture of 0 leaves whatever is bound alone.
+
+struct DrawCommand {
+    SortKey key = 0;
+    unsigned int program = 0;
+    unsigned int vertex_array = 0;
+    unsigned int texture = 0;
+    unsigned int texture_target = 0;
+    unsigned int texture_unit = 0;
+    unsigned int primitive = 0;
+    int first = 0;
+    int count = 0;
+    // 0 draws without instancing
+    int instance_count = 0;
+};
+
+// Collects the draws for a frame on the render thread, sorts them and then issues them.
+// Binds go through the GL state cache so the ones that wouldn't change anything are
+// skipped.
+
+class RenderQueue {
+public:
+    struct Stats {
+        size_t draw_calls = 0;
+        size_t program_binds = 0;
+        size_t texture_binds = 0;
+        size_t vertex_array_binds = 0;
+        // Binds a naive submission would have made that were skipped
+        size_t elided_binds = 0;
+
+        size_t getStateChanges() const;
+    };
+
+    RenderQueue() = default;
+    DELETE_COPY(RenderQueue);
+    DELETE_MOVE(RenderQueue);
+
+    void submit(const DrawCommand& command);
+    // Orders the submitted commands by key, ties keep their submission order
+    void sort();
+    // Sorts, draws and clears the queue
+    void flush();
+    // Drops everything submitted without drawing it
+    void clear();
+
+    size_t size() const;
+    const std::vector<DrawCommand>& getCommands() const;
+    // Counters from the last flush
+    const Stats& getStats() const;
+
+private:
+    void execute();
+
+    struct Entry {
+        SortKey key;
+        uint32_t index;
+    };
+
+    std::vector<DrawCommand> commands;
+    // The radix sort only moves keys and indices around, commands are gathered once at
+    // the end. All of these are kept to avoid reallocating every frame.
+    std::vector<Entry> entries;
+    std::vector<Entry> scratch;
+    std::vector<DrawCommand> sorted;
+    Stats stats;
+};
+
+} // namespace Engine
@@ -2,6 +2,7 @@
 
 #include "renderer.hpp"
 #include "opengl.hpp"
+#include "gl_state.hpp"
 #include <backends/imgui_impl_opengl3.h>
 
 namespace Engine {
@@ -11,6 +12,9 @@ Renderer::Renderer()
     OPENGL_CALL(glEnable(GL_DEBUG_OUTPUT));
     OPENGL_CALL(glDebugMessageCallback(debugCallback, nullptr));
     OPENGL_CALL(glDisable(GL_DEPTH_TEST));
+    // Textured sprites have transparent edges
+    GL_STATE.setBlend(true);
+    GL_STATE.setBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
     ImGui_ImplOpenGL3_Init("#version 410");
 }
 
@@ -21,6 +25,11 @@ Renderer::~Renderer()
 
 void Renderer::setViewport(size_t width, size_t height)
 {
+    if (width == viewport_width && height == viewport_height) {
+        return;
+    }
+    viewport_width = width;
+    viewport_height = height;
     OPENGL_CALL(glViewport(0, 0, static_cast<GLint>(width), static_cast<GLint>(height)));
 }
 
@@ -35,6 +44,21 @@ void Renderer::clearBackground()
     OPENGL_CALL(glClear(GL_COLOR_BUFFER_BIT));
 }
 
+void Renderer::submit(const DrawCommand& command)
+{
+    queue.submit(command);
+}
+
+void Renderer::flush()
+{
+    queue.flush();
+}
+
+const RenderQueue& Renderer::getQueue() const
+{
+    return queue;
+}
+
 void Renderer::debugCallback(
     GLenum source,
     GLenum type,
@@ -48,10 +72,10 @@ void Renderer::debugCallback(
     switch (type) {
     case GL_DEBUG_TYPE_ERROR: {
         switch(severity) {
-        case GL_DEBUG_SEVERITY_HIGH: Log::error("{}", message); break;
-        case GL_DEBUG_SEVERITY_MEDIUM: Log::warn("{}", message); break;
-        case GL_DEBUG_SEVERITY_LOW: Log::info("{}", message); break;
-        case GL_DEBUG_SEVERITY_NOTIFICATION: Log::debug("{}", message); break;
+        case GL_DEBUG_SEVERITY_HIGH: Log::error(Log::Category::Render, "{}", message); break;
+        case GL_DEBUG_SEVERITY_MEDIUM: Log::warn(Log::Category::Render, "{}", message); break;
+        case GL_DEBUG_SEVERITY_LOW: Log::info(Log::Category::Render, "{}", message); break;
+        case GL_DEBUG_SEVERITY_NOTIFICATION: Log::debug(Log::Category::Render, "{}", message); break;
         default: break;
         }
     }
@@ -1,5 +1,6 @@
 #pragma once
 
+#include "render_queue.hpp"
 #include <cstddef>
 #include <glm/fwd.hpp>
 
@@ -13,6 +14,12 @@ public:
     void setBackgroundColor(const glm::vec3& color);
     void clearBackground();
 
+    // Draws go through the queue so they can be sorted and redundant binds skipped,
+    // nothing is drawn until flush
+    void submit(const DrawCommand& command);
+    void flush();
+    const RenderQueue& getQueue() const;
+
 private:
     static void debugCallback(GLenum source,
         GLenum type,
@@ -23,7 +30,10 @@ private:
         const void* userParam
     );
 
+    RenderQueue queue;
     glm::vec3 background_color = { 0.2f, 0.3f, 0.3f };
+    size_t viewport_width = 0;
+    size_t viewport_height = 0;
 };
 
 } // namespace Engine
@@ -0,0 +1,116 @@
+#include <pch.hpp>
+
+#include "skyline_packer.hpp"
+#include <algorithm>
+#include <limits>
+
+namespace Engine {
+
+SkylinePacker::SkylinePacker(int width, int height)
+    : width(width), height(height)
+{
+    reset();
+}
+
+void SkylinePacker::reset()
+{
+    skyline.clear();
+    skyline.push_back({ 0, 0, width });
+    used_area = 0;
+}
+
+float SkylinePacker::getOccupancy() const
+{
+    return static_cast<float>(used_area) / (static_cast<float>(width) * static_cast<float>(height));
+}
+
+std::optional<int> SkylinePacker::fit(size_t index, int rect_width, int rect_height) const
+{
+    const int x = skyline[index].x;
+    if (x + rect_width > width) {
+        return std::nullopt;
+    }
+
+    int y = skyline[index].y;
+    int remaining = rect_width;
+    for (size_t i = index; remaining > 0; i++) {
+        if (i == skyline.size()) {
+            return std::nullopt;
+        }
+        y = std::max(y, skyline[i].y);
+        if (y + rect_height > height) {
+            return std::nullopt;
+        }
+        remaining -= skyline[i].width;
+    }
+    return y;
+}
+
+// Picks the spot that leaves the top edge lowest, ties go to the narrowest segment so
+// wide gaps stay open for wide images
+
+std::optional<glm::ivec2> SkylinePacker::insert(int rect_width, int rect_height)
+{
+    if (rect_width <= 0 || rect_height <= 0) {
+        return std::nullopt;
+    }
+
+    std::optional<size_t> best_index;
+    int best_top = std::numeric_limits<int>::max();
+    int best_width = std::numeric_limits<int>::max();
+    glm::ivec2 best_position(0);
+
+    for (size_t i = 0; i < skyline.size(); i++) {
+        const std::optional<int> y = fit(i, rect_width, rect_height);
+        if (!y) {
+            continue;
+        }
+        const int top = *y + rect_height;
+        if (top < best_top || (top == best_top && skyline[i].width < best_width)) {
+            best_index = i;
+            best_top = top;
+            best_width = skyline[i].width;
+            best_position = glm::ivec2(skyline[i].x, *y);
+        }
+    }
+
+    if (!best_index) {
+        return std::nullopt;
+    }
+    place(*best_index, best_position, rect_width, rect_height);
+    return best_position;
+}
+
+void SkylinePacker::place(size_t index, glm::ivec2 position, int rect_width, int rect_height)
+{
+    skyline.insert(skyline.begin() + static_cast<std::ptrdiff_t>(index), { position.x, position.y + rect_height, rect_width });
+
+    // Everything the new segment covers gets cut back or dropped
+    for (size_t i = index + 1; i < skyline.size();) {
+        const Segment& previous = skyline[i - 1];
+        Segment& segment = skyline[i];
+        const int overlap = previous.x + previous.width - segment.x;
+        if (overlap <= 0) {
+            break;
+        }
+        segment.x += overlap;
+        segment.width -= overlap;
+        if (segment.width > 0) {
+            break;
+        }
+        skyline.erase(skyline.begin() + static_cast<std::ptrdiff_t>(i));
+    }
+
+    for (size_t i = 0; i + 1 < skyline.size();) {
+        if (skyline[i].y == skyline[i + 1].y) {
+            skyline[i].width += skyline[i + 1].width;
+            skyline.erase(skyline.begin() + static_cast<std::ptrdiff_t>(i + 1));
+        } else {
+            i++;
+        }
+    }
+
+    used_area += static_cast<long long>(rect_width) * rect_height;
+}
+
+} // namespace Engine
@@ -0,0 +1,41 @@
+#pragma once
+
+#include <optional>
+#include <vector>
+#include <glm/glm.hpp>
+
+namespace Engine {
+
+// Packs rectangles into a fixed size area using the skyline bottom-left heuristic. Only
+// the top edge of everything placed so far is tracked, so space under an overhang is
+// lost, but inserts stay cheap and sprite images pack tightly enough for an atlas.
+
+class SkylinePacker {
+public:
+    SkylinePacker(int width, int height);
+
+    // Top left corner of the placed rectangle, empty when it doesn't fit anywhere
+    std::optional<glm::ivec2> insert(int width, int height);
+    void reset();
+
+    // Fraction of the area covered by inserted rectangles
+    float getOccupancy() const;
+
+private:
+    struct Segment {
+        int x;
+        int y;
+        int width;
+    };
+
+    // Lowest y a rectangle starting at segment index can sit at
+    std::optional<int> fit(size_t index, int width, int height) const;
+    void place(size_t index, glm::ivec2 position, int width, int height);
+
+    std::vector<Segment> skyline;
+    int width;
+    int height;
+    long long used_area = 0;
+};
+
+} // namespace Engine
@@ -0,0 +1,173 @@
+#include <pch.hpp>
+
+#include "texture_atlas.hpp"
+#include "opengl.hpp"
+#include "gl_state.hpp"
+#include "../resource/texture.hpp"
+#include <cstring>
+
+namespace Engine {
+
+TextureAtlas::TextureAtlas(int page_size)
+    : page_size(page_size)
+{
+    OPENGL_CALL(glGenTextures(1, &texture));
+    GL_STATE.bindTexture(GL_TEXTURE_2D_ARRAY, texture);
+    // Sprites are drawn at whole texels most of the time, nearest keeps pixel art crisp
+    // and never samples outside the padding
+    OPENGL_CALL(glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MIN_FILTER, GL_NEAREST));
+    OPENGL_CALL(glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MAG_FILTER, GL_NEAREST));
+    OPENGL_CALL(glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE));
+    OPENGL_CALL(glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE));
+    GL_STATE.bindTexture(GL_TEXTURE_2D_ARRAY, 0);
+}
+
+TextureAtlas::~TextureAtlas()
+{
+    GL_STATE.deleteTexture(texture);
+}
+
+std::optional<AtlasRegion> TextureAtlas::add(const Texture& texture)
+{
+    if (const auto it = regions.find(&texture); it != regions.end()) {
+        return it->second;
+    }
+    if (!texture.isValid()) {
+        return std::nullopt;
+    }
+
+    const int width = texture.getWidth();
+    const int height = texture.getHeight();
+    const int padded_width = width + PADDING * 2;
+    const int padded_height = height + PADDING * 2;
+    if (padded_width > page_size || padded_height > page_size) {
+        Log::warn(Log::Category::Render, "Texture of {}x{} doesn't fit in a {}x{} atlas page", width, height, page_size, page_size);
+        return std::nullopt;
+    }
+
+    // Earlier pages first so small images fill in the gaps left behind
+    size_t layer = 0;
+    std::optional<glm::ivec2> position;
+    for (; layer < packers.size() && !position; layer++) {
+        position = packers[layer].insert(padded_width, padded_height);
+    }
+    if (position) {
+        layer--;
+    } else {
+        packers.emplace_back(page_size, page_size);
+        layer = packers.size() - 1;
+        position = packers[layer].insert(padded_width, padded_height);
+    }
+
+    const glm::ivec2 origin = *position + PADDING;
+    const std::span<const uint8_t> pixels = texture.getPixels();
+    pending.uploads.push_back(AtlasUpload {
+        .layer = layer,
+        .origin = origin,
+        .size = glm::ivec2(width, height),
+        .pixels = std::vector<uint8_t>(pixels.begin(), pixels.end()),
+    });
+
+    const float size = static_cast<float>(page_size);
+    const AtlasRegion region {
+        .layer = static_cast<float>(layer),
+        .uv_rect = glm::vec4(
+            static_cast<float>(origin.x) / size,
+            static_cast<float>(origin.y) / size,
+            static_cast<float>(origin.x + width) / size,
+            static_cast<float>(origin.y + height) / size
+        ),
+    };
+    regions.emplace(&texture, region);
+    return region;
+}
+
+std::shared_ptr<const AtlasUpdate> TextureAtlas::takeUpdate()
+{
+    if (pending.uploads.empty()) {
+        return nullptr;
+    }
+    pending.page_count = packers.size();
+    auto update = std::make_shared<const AtlasUpdate>(std::move(pending));
+    pending = AtlasUpdate {};
+    return update;
+}
+
+size_t TextureAtlas::getPageCount() const
+{
+    return packers.size();
+}
+
+int TextureAtlas::getPageSize() const
+{
+    return page_size;
+}
+
+void TextureAtlas::upload(const std::shared_ptr<const AtlasUpdate>& update)
+{
+    if (!update) {
+        return;
+    }
+
+    const size_t page_bytes = static_cast<size_t>(page_size) * static_cast<size_t>(page_size) * Texture::CHANNELS;
+    while (pages.size() < update->page_count) {
+        pages.emplace_back(page_bytes, 0);
+    }
+
+    for (const AtlasUpload& upload : update->uploads) {
+        std::vector<uint8_t>& page = pages[upload.layer];
+        const size_t row_size = static_cast<size_t>(upload.size.x) * Texture::CHANNELS;
+        for (int row = 0; row < upload.size.y; row++) {
+            const size_t destination = (static_cast<size_t>(upload.origin.y + row) * static_cast<size_t>(page_size) + static_cast<size_t>(upload.origin.x)) * Texture::CHANNELS;
+            std::memcpy(page.data() + destination, upload.pixels.data() + static_cast<size_t>(row) * row_size, row_size);
+        }
+    }
+
+    GL_STATE.bindTexture(GL_TEXTURE_2D_ARRAY, texture);
+
+    // Growing the array texture throws away its contents, every page goes up again
+    if (pages.size() > allocated_layers) {
+        allocateLayers();
+        return;
+    }
+
+    for (const AtlasUpload& upload : update->uploads) {
+        OPENGL_CALL(glTexSubImage3D(
+            GL_TEXTURE_2D_ARRAY, 0,
+            upload.origin.x, upload.origin.y, static_cast<GLint>(upload.layer),
+            upload.size.x, upload.size.y, 1,
+            GL_RGBA, GL_UNSIGNED_BYTE, upload.pixels.data()
+        ));
+    }
+}
+
+void TextureAtlas::allocateLayers()
+{
+    OPENGL_CALL(glTexImage3D(
+        GL_TEXTURE_2D_ARRAY, 0, GL_RGBA8,
+        page_size, page_size, static_cast<GLsizei>(pages.size()),
+        0, GL_RGBA, GL_UNSIGNED_BYTE, nullptr
+    ));
+    allocated_layers = pages.size();
+
+    for (size_t layer = 0; layer < pages.size(); layer++) {
+        OPENGL_CALL(glTexSubImage3D(
+            GL_TEXTURE_2D_ARRAY, 0,
+            0, 0, static_cast<GLint>(layer),
+            page_size, page_size, 1,
+            GL_RGBA, GL_UNSIGNED_BYTE, pages[layer].data()
+        ));
+    }
+}
+
+void TextureAtlas::bind(unsigned int unit) const
+{
+    GL_STATE.bindTexture(unit, GL_TEXTURE_2D_ARRAY, texture);
+}
+
+unsigned int TextureAtlas::getHandle() const
+{
+    return texture;
+}
+
+} // namespace Engine
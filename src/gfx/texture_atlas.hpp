@@ -0,0 +1,85 @@
+#pragma once
+
+#include "skyline_packer.hpp"
+#include "../constructors.hpp"
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <unordered_map>
+#include <vector>
+#include <glm/glm.hpp>
+
+namespace Engine {
+
+class Texture;
+
+// Where a texture ended up, layer of the array texture and its rect in UV space with v
+// going down the image. Layer -1 means untextured.
+
+struct AtlasRegion {
+    constexpr static float UNTEXTURED = -1.f;
+
+    float layer = UNTEXTURED;
+    glm::vec4 uv_rect = glm::vec4(0.f, 0.f, 1.f, 1.f);
+};
+
+// Pixels of one added texture and where on which page they go
+struct AtlasUpload {
+    size_t layer = 0;
+    glm::ivec2 origin = glm::ivec2(0, 0);
+    glm::ivec2 size = glm::ivec2(0, 0);
+    std::vector<uint8_t> pixels;
+};
+
+// Everything added since the previous update was taken
+struct AtlasUpdate {
+    size_t page_count = 0;
+    std::vector<AtlasUpload> uploads;
+};
+
+// Packs textures into the layers of one array texture so sprites with different images
+// can all go out in a single draw. Textures are added on the simulation thread, which only
+// keeps the packers and a copy of what was added since the last update. The render thread
+// keeps the CPU copy of the pages, it writes each update into them and uploads just the
+// added rects. Only growing the array texture sends whole pages again. Every update has
+// to reach upload, in the order they were taken.
+
+class TextureAtlas {
+public:
+    constexpr static int DEFAULT_PAGE_SIZE = 2048;
+    // Empty border around each image so neighbours don't bleed into each other
+    constexpr static int PADDING = 1;
+
+    explicit TextureAtlas(int page_size = DEFAULT_PAGE_SIZE);
+    ~TextureAtlas();
+    DELETE_COPY(TextureAtlas);
+    DELETE_MOVE(TextureAtlas);
+
+    // Adding the same texture again returns the region from the first time. Empty if the
+    // texture is invalid or bigger than a page.
+    std::optional<AtlasRegion> add(const Texture& texture);
+    // Empty when nothing was added since the last one
+    std::shared_ptr<const AtlasUpdate> takeUpdate();
+    size_t getPageCount() const;
+    int getPageSize() const;
+
+    // Render thread only
+    void upload(const std::shared_ptr<const AtlasUpdate>& update);
+    void bind(unsigned int unit) const;
+    unsigned int getHandle() const;
+
+private:
+    void allocateLayers();
+
+    int page_size;
+    std::vector<SkylinePacker> packers;
+    std::unordered_map<const Texture*, AtlasRegion> regions;
+    AtlasUpdate pending;
+
+    // Render thread only
+    unsigned int texture = 0;
+    std::vector<std::vector<uint8_t>> pages;
+    size_t allocated_layers = 0;
+};
+
+} // namespace Engine
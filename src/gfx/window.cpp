@@ -2,8 +2,6 @@
 #include <pch.hpp>
 
 #include "window.hpp"
-#include "renderer.hpp"
-#include <backends/imgui_impl_sdl2.h>
 
 constexpr int DEFAULT_WIDTH = 1280;
 constexpr int DEFAULT_HEIGHT = 720;
@@ -12,11 +10,14 @@ namespace Engine {
 
 int eventHandler(void *user_data, SDL_Event *event);
 
-Window::Window()
+Window::Window(WindowMode mode)
 {
-    Log::debug("Attempting to create SDL window");
+    Log::debug(Log::Category::Render, "Attempting to create SDL window");
+    if (mode == WindowMode::Headless) {
+        SDL_SetHintWithPriority(SDL_HINT_VIDEODRIVER, "offscreen", SDL_HINT_DEFAULT);
+    }
     if (SDL_Init(SDL_INIT_VIDEO) != 0) {
-        Log::error("Failed to initialize SDL");
+        Log::error(Log::Category::Render, "Failed to initialize SDL");
         std::exit(EXIT_FAILURE);
     }
 
@@ -34,31 +35,29 @@ Window::Window()
         SDL_WINDOWPOS_UNDEFINED, 
         DEFAULT_WIDTH, 
         DEFAULT_HEIGHT, 
-        SDL_WINDOW_SHOWN | SDL_WINDOW_RESIZABLE | SDL_WINDOW_OPENGL
+        (mode == WindowMode::Headless ? SDL_WINDOW_HIDDEN : SDL_WINDOW_SHOWN) | SDL_WINDOW_RESIZABLE | SDL_WINDOW_OPENGL
     );
 
     if (handle == nullptr) {
-        Log::error("Failed to create SDL window");
+        Log::error(Log::Category::Render, "Failed to create SDL window: {}", SDL_GetError());
         std::exit(EXIT_FAILURE);
     }
 
     gl_context = SDL_GL_CreateContext(handle);
     if (gl_context == nullptr) {
-        Log::error("Failed to create OpenGL context for SDL");
+        Log::error(Log::Category::Render, "Failed to create OpenGL context for SDL");
         std::exit(EXIT_FAILURE);
     }
 
     if (!gladLoadGLLoader(SDL_GL_GetProcAddress)) {
-        Log::error("Failed to load GLAD for OpenGL");
+        Log::error(Log::Category::Render, "Failed to load GLAD for OpenGL");
         std::exit(EXIT_FAILURE);
     }
 
-    ImGui_ImplSDL2_InitForOpenGL(handle, gl_context);
-
-    Log::info("Loaded OpenGL");
-    Log::info("Vendor: {}", std::string_view{reinterpret_cast<const char *>(glGetString(GL_VENDOR))});
-    Log::info("Renderer: {}", std::string_view{reinterpret_cast<const char *>(glGetString(GL_RENDERER))});
-    Log::info("Version: {}", std::string_view{reinterpret_cast<const char *>(glGetString(GL_VERSION))});
+    Log::info(Log::Category::Render, "Loaded OpenGL");
+    Log::info(Log::Category::Render, "Vendor: {}", std::string_view{reinterpret_cast<const char *>(glGetString(GL_VENDOR))});
+    Log::info(Log::Category::Render, "Renderer: {}", std::string_view{reinterpret_cast<const char *>(glGetString(GL_RENDERER))});
+    Log::info(Log::Category::Render, "Version: {}", std::string_view{reinterpret_cast<const char *>(glGetString(GL_VERSION))});
 
     size.x = DEFAULT_WIDTH;
     size.y = DEFAULT_HEIGHT;
@@ -68,8 +67,7 @@ Window::Window()
 
 Window::~Window()
 {
-    Log::debug("Destroying SDL window");
-    ImGui_ImplSDL2_Shutdown();
+    Log::debug(Log::Category::Render, "Destroying SDL window");
     SDL_GL_DeleteContext(gl_context);
     SDL_DestroyWindow(handle);
     SDL_Quit();
@@ -80,9 +78,31 @@ glm::vec2 Window::getSize() const
     return size;
 }
 
-void Window::setRenderer(Renderer* renderer)
+glm::vec2 Window::getDrawableSize() const
+{
+    int width = 0;
+    int height = 0;
+    SDL_GL_GetDrawableSize(handle, &width, &height);
+    return glm::vec2(static_cast<float>(width), static_cast<float>(height));
+}
+
+void Window::acquireContext() const
+{
+    if (SDL_GL_MakeCurrent(handle, gl_context) != 0) {
+        Log::error(Log::Category::Render, "Failed to make OpenGL context current: {}", SDL_GetError());
+        std::exit(EXIT_FAILURE);
+    }
+}
+
+void Window::releaseContext() const
 {
-    this->renderer = renderer;
+    SDL_GL_MakeCurrent(handle, nullptr);
+}
+
+void Window::setVSync(bool enable)
+{
+    vsync = enable;
+    vsync_changed = true;
 }
 
 PlatformDisplayData Window::getPlatformData() const
@@ -103,8 +123,11 @@ PlatformDisplayData Window::getPlatformData() const
     return data;
 }
 
-void Window::swapBuffers() const
+void Window::swapBuffers()
 {
+    if (vsync_changed.exchange(false)) {
+        SDL_GL_SetSwapInterval(vsync ? 1 : 0);
+    }
     SDL_GL_SwapWindow(handle);
 }
 
@@ -112,7 +135,6 @@ int eventHandler(void* user_data, SDL_Event* event)
 {
     Window* window = static_cast<Window*>(user_data);
     assert(window != nullptr);
-    assert(window->renderer != nullptr);
 
     switch (event->type) {
     case SDL_WINDOWEVENT:
@@ -121,8 +143,7 @@ int eventHandler(void* user_data, SDL_Event* event)
             SDL_GetWindowSize(window->handle, &width, &height);
             window->size.x = static_cast<float>(width);
             window->size.y = static_cast<float>(height);
-            window->renderer->setViewport(static_cast<size_t>(width), static_cast<size_t>(height));
-            Log::debug("Window size changed: ({}, {})", width, height);
+            Log::debug(Log::Category::Render, "Window size changed: ({}, {})", width, height);
         }
         break;
     default:
@@ -2,35 +2,51 @@
 
 #include "../constructors.hpp"
 #include <SDL.h>
+#include <atomic>
 #include <glm/fwd.hpp>
 
 namespace Engine {
 
-class Renderer;
-
 struct PlatformDisplayData {
     void* display;
     void* window;
 };
 
+enum class WindowMode {
+    Windowed,
+    // Hidden window on SDL's offscreen driver, GL still works through EGL so the full
+    // frame runs without a display. Setting SDL_VIDEODRIVER overrides the driver.
+    Headless,
+};
+
 class Window {
 public:
-    Window();
+    explicit Window(WindowMode mode = WindowMode::Windowed);
     ~Window();
     DELETE_COPY(Window);
-    DEFAULT_MOVE(Window);
+    DELETE_MOVE(Window);
 
     glm::vec2 getSize() const;
-    void setRenderer(Renderer* renderer);
+    // In pixels, which can differ from the size on high DPI displays. Main thread only.
+    glm::vec2 getDrawableSize() const;
     PlatformDisplayData getPlatformData() const;
-    void swapBuffers() const;
+    void swapBuffers();
+
+    // Makes the GL context current on the calling thread, or releases it so another
+    // thread can take it
+    void acquireContext() const;
+    void releaseContext() const;
+
+    // Safe to call from any thread, applied by whichever thread next swaps buffers
+    void setVSync(bool enable);
     
 private:
     friend int eventHandler(void *user_data, SDL_Event *event);
     
-    Renderer* renderer = nullptr;
     SDL_Window* handle = nullptr;
     glm::vec2 size = { 0.f, 0.f };
+    std::atomic<bool> vsync = false;
+    std::atomic<bool> vsync_changed = false;
 
     SDL_GLContext gl_context;
 };
@@ -0,0 +1,133 @@
+#include <pch.hpp>
+
+#include "launch_options.hpp"
+#include <charconv>
+#include <cstdlib>
+#include <iostream>
+#include <string_view>
+
+namespace Engine {
+
+constexpr std::string_view USAGE = R"(Usage: game [options]
+  --headless              Render offscreen without showing a window
+  --frames <count>        Quit after this many frames
+  --delta-time <seconds>  Use a fixed delta time instead of the measured one
+  --script <path>         Entry script relative to resources, defaults to main.lua
+  --report <path>         Write a JSON frame timing report on exit
+  --record <path>         Record frame deltas and input events to a binary log
+  --replay <path>         Replay a recorded log instead of live input and timing
+  --log-overflow <policy> drop (default) or block when the log queue is full
+  --log-binary <path>     Write the log in binary to path instead of text, read it
+                          back with log_decode
+  --log-level [<category>=]<level>
+                          Only log messages at or above debug, info, warning or
+                          error, for one of general, render, resource, lua or jobs
+                          if given. Can be repeated.
+  --help                  Show this message
+)";
+
+[[noreturn]] static void exitWithUsage(int code)
+{
+    (code == EXIT_SUCCESS ? std::cout : std::cerr) << USAGE;
+    std::exit(code);
+}
+
+template <typename T>
+static T parseNumber(std::string_view flag, std::string_view text)
+{
+    T value {};
+    const auto [end, error] = std::from_chars(text.data(), text.data() + text.size(), value);
+    if (error != std::errc() || end != text.data() + text.size()) {
+        Log::error("Invalid value \"{}\" for {}", text, flag);
+        exitWithUsage(EXIT_FAILURE);
+    }
+    return value;
+}
+
+LaunchOptions parseLaunchOptions(int argc, char** argv)
+{
+    LaunchOptions options;
+
+    for (int i = 1; i < argc; i++) {
+        const std::string_view flag = argv[i];
+        auto value = [&]() -> std::string_view {
+            if (i + 1 >= argc) {
+                Log::error("Missing value for {}", flag);
+                exitWithUsage(EXIT_FAILURE);
+            }
+            return argv[++i];
+        };
+
+        if (flag == "--headless") {
+            options.headless = true;
+        } else if (flag == "--frames") {
+            options.frame_count = parseNumber<uint64_t>(flag, value());
+        } else if (flag == "--delta-time") {
+            const float delta_time = parseNumber<float>(flag, value());
+            if (delta_time <= 0.f) {
+                Log::error("--delta-time has to be positive, got {}", delta_time);
+                exitWithUsage(EXIT_FAILURE);
+            }
+            options.fixed_delta_time = delta_time;
+        } else if (flag == "--script") {
+            options.entry_script = value();
+        } else if (flag == "--report") {
+            options.report_path = value();
+        } else if (flag == "--record") {
+            options.record_path = value();
+        } else if (flag == "--replay") {
+            options.replay_path = value();
+        } else if (flag == "--log-overflow") {
+            const std::string_view policy = value();
+            if (policy == "drop") {
+                options.log_overflow = Log::Logger::OverflowPolicy::Drop;
+            } else if (policy == "block") {
+                options.log_overflow = Log::Logger::OverflowPolicy::Block;
+            } else {
+                Log::error("Unknown log overflow policy \"{}\"", policy);
+                exitWithUsage(EXIT_FAILURE);
+            }
+        } else if (flag == "--log-binary") {
+            options.log_binary_path = value();
+        } else if (flag == "--log-level") {
+            const std::string_view setting = value();
+            const size_t separator = setting.find('=');
+            std::optional<Log::Category> category;
+            if (separator != std::string_view::npos) {
+                category = Log::parseCategory(setting.substr(0, separator));
+                if (!category) {
+                    Log::error("Unknown log category \"{}\"", setting.substr(0, separator));
+                    exitWithUsage(EXIT_FAILURE);
+                }
+            }
+            const std::string_view level = separator == std::string_view::npos ? setting : setting.substr(separator + 1);
+            const auto severity = Log::parseSeverity(level);
+            if (!severity) {
+                Log::error("Unknown log level \"{}\"", level);
+                exitWithUsage(EXIT_FAILURE);
+            }
+            options.log_levels.emplace_back(category, *severity);
+        } else if (flag == "--help") {
+            exitWithUsage(EXIT_SUCCESS);
+        } else {
+            Log::error("Unknown option {}", flag);
+            exitWithUsage(EXIT_FAILURE);
+        }
+    }
+
+    if (options.record_path && options.replay_path) {
+        Log::error("--record and --replay can't be used together");
+        exitWithUsage(EXIT_FAILURE);
+    }
+    if (options.replay_path && options.fixed_delta_time) {
+        Log::warn("--delta-time is ignored while replaying, the recorded deltas are used");
+    }
+
+    if (options.headless && options.frame_count == 0 && !options.replay_path) {
+        Log::warn("Running headless without --frames, the game will only stop when killed");
+    }
+
+    return options;
+}
+
+} // namespace Engine
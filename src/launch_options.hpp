@@ -0,0 +1,39 @@
+#pragma once
+
+#include "logging.hpp"
+#include <cstdint>
+#include <filesystem>
+#include <optional>
+#include <vector>
+
+namespace Engine {
+
+struct LaunchOptions {
+    // Offscreen window, meant for CI and benchmarking runs without a display
+    bool headless = false;
+    // Quit after this many frames, 0 runs until the window is closed
+    uint64_t frame_count = 0;
+    // Feed this delta time to the simulation instead of the measured one
+    std::optional<float> fixed_delta_time;
+    // Relative to the resources folder
+    std::filesystem::path entry_script = "main.lua";
+    // Frame timing summary written as JSON on exit
+    std::optional<std::filesystem::path> report_path;
+    // Input log to write every frame's delta time and input events to
+    std::optional<std::filesystem::path> record_path;
+    // Input log to take delta times and input from instead of the clock and SDL, the run
+    // ends when it runs out
+    std::optional<std::filesystem::path> replay_path;
+    // Whether logging blocks or drops messages when the async log queue is full
+    Log::Logger::OverflowPolicy log_overflow = Log::Logger::OverflowPolicy::Drop;
+    // Write the log here in the binary format instead of text to stdout, decode it with
+    // the log_decode tool
+    std::optional<std::filesystem::path> log_binary_path;
+    // Runtime log levels in the order given, no category means all of them
+    std::vector<std::pair<std::optional<Log::Category>, Log::Logger::Severity>> log_levels;
+};
+
+// Exits with usage on anything it doesn't understand
+LaunchOptions parseLaunchOptions(int argc, char** argv);
+
+} // namespace Engine
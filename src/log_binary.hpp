@@ -0,0 +1,113 @@
+#pragma once
+
+#include <array>
+#include <concepts>
+#include <cstdint>
+#include <cstring>
+#include <format>
+#include <string>
+#include <string_view>
+#include <type_traits>
+
+// Binary log layout, written by the async logger and read back by the log_decode tool.
+// Instead of the formatted text every message only carries the id of its call site and
+// the raw bytes of its arguments. A call site is described once, the first time it logs.
+//
+// Everything is little endian as written by the host:
+//   header:  "GLOG" magic, u32 version
+//   site:    u8 'S', u32 id, u8 severity, u8 flags, u32 line, string file,
+//            string format, u8 argument count, u8 type per argument
+//   message: u8 'M', u32 site id, each argument encoded by its type
+// Strings are a u32 length and the bytes, everything else is the value as is. Sites with
+// the CUSTOM_PREFIX flag have no file, their first argument is the prefix to print.
+
+namespace Engine::Log::Binary {
+
+constexpr std::array<char, 4> MAGIC = { 'G', 'L', 'O', 'G' };
+constexpr uint32_t VERSION = 1;
+
+constexpr char SITE_RECORD = 'S';
+constexpr char MESSAGE_RECORD = 'M';
+
+constexpr uint8_t CUSTOM_PREFIX = 1 << 0;
+
+enum class ArgType : uint8_t {
+    Bool,
+    Char,
+    Int32,
+    Int64,
+    UInt32,
+    UInt64,
+    Float,
+    Double,
+    String,
+    Pointer,
+    // No binary encoding, formatted with "{}" when written and stored as a string
+    Formatted,
+};
+
+template <typename T>
+consteval ArgType argType()
+{
+    if constexpr (std::is_same_v<T, bool>) {
+        return ArgType::Bool;
+    } else if constexpr (std::is_same_v<T, char>) {
+        return ArgType::Char;
+    } else if constexpr (std::signed_integral<T>) {
+        return sizeof(T) <= 4 ? ArgType::Int32 : ArgType::Int64;
+    } else if constexpr (std::unsigned_integral<T>) {
+        return sizeof(T) <= 4 ? ArgType::UInt32 : ArgType::UInt64;
+    } else if constexpr (std::is_same_v<T, float>) {
+        return ArgType::Float;
+    } else if constexpr (std::is_same_v<T, double>) {
+        return ArgType::Double;
+    } else if constexpr (std::is_convertible_v<const T&, std::string_view>) {
+        return ArgType::String;
+    } else if constexpr (std::is_pointer_v<T> || std::is_null_pointer_v<T>) {
+        return ArgType::Pointer;
+    } else {
+        return ArgType::Formatted;
+    }
+}
+
+template <typename T>
+void appendValue(std::string& out, const T& value)
+{
+    static_assert(std::is_trivially_copyable_v<T>);
+    const size_t offset = out.size();
+    out.resize(offset + sizeof(T));
+    std::memcpy(out.data() + offset, &value, sizeof(T));
+}
+
+inline void appendString(std::string& out, std::string_view text)
+{
+    appendValue(out, static_cast<uint32_t>(text.size()));
+    out.append(text);
+}
+
+template <typename T>
+void appendArg(std::string& out, const T& value)
+{
+    constexpr ArgType type = argType<T>();
+    if constexpr (type == ArgType::Bool || type == ArgType::Char || type == ArgType::Float || type == ArgType::Double) {
+        appendValue(out, value);
+    } else if constexpr (type == ArgType::Int32) {
+        appendValue(out, static_cast<int32_t>(value));
+    } else if constexpr (type == ArgType::Int64) {
+        appendValue(out, static_cast<int64_t>(value));
+    } else if constexpr (type == ArgType::UInt32) {
+        appendValue(out, static_cast<uint32_t>(value));
+    } else if constexpr (type == ArgType::UInt64) {
+        appendValue(out, static_cast<uint64_t>(value));
+    } else if constexpr (type == ArgType::String) {
+        appendString(out, std::string_view(value));
+    } else if constexpr (std::is_null_pointer_v<T>) {
+        appendValue(out, uint64_t { 0 });
+    } else if constexpr (type == ArgType::Pointer) {
+        appendValue(out, static_cast<uint64_t>(reinterpret_cast<uintptr_t>(value)));
+    } else {
+        appendString(out, std::format("{}", value));
+    }
+}
+
+} // namespace Engine::Log::Binary
@@ -0,0 +1,99 @@
+#pragma once
+
+#include "constructors.hpp"
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <cstddef>
+#include <memory>
+#include <optional>
+
+namespace Engine::Log {
+
+// Bounded lock-free queue for many producers and a single consumer. Each slot carries a
+// sequence number that says whether it's free for the producer at a given position or
+// holds a value for the consumer, so producers only contend on a single CAS.
+
+template <typename T>
+class MpscRing {
+public:
+    explicit MpscRing(size_t capacity);
+    DELETE_COPY(MpscRing);
+    DELETE_MOVE(MpscRing);
+
+    // Fails without blocking when the ring is full
+    bool tryPush(T&& value);
+    // Only ever called from the consumer thread
+    std::optional<T> tryPop();
+
+    size_t capacity() const;
+
+private:
+    struct Slot {
+        std::atomic<size_t> sequence;
+        T value;
+    };
+
+    std::unique_ptr<Slot[]> slots;
+    size_t mask;
+    alignas(64) std::atomic<size_t> enqueue_position = 0;
+    alignas(64) size_t dequeue_position = 0;
+};
+
+template <typename T>
+MpscRing<T>::MpscRing(size_t capacity)
+{
+    capacity = std::bit_ceil(std::max<size_t>(capacity, 2));
+    slots = std::make_unique<Slot[]>(capacity);
+    mask = capacity - 1;
+    for (size_t i = 0; i < capacity; i++) {
+        slots[i].sequence.store(i, std::memory_order_relaxed);
+    }
+}
+
+template <typename T>
+bool MpscRing<T>::tryPush(T&& value)
+{
+    size_t position = enqueue_position.load(std::memory_order_relaxed);
+    Slot* slot;
+    while (true) {
+        slot = &slots[position & mask];
+        const size_t sequence = slot->sequence.load(std::memory_order_acquire);
+        const auto difference = static_cast<std::ptrdiff_t>(sequence) - static_cast<std::ptrdiff_t>(position);
+        if (difference == 0) {
+            if (enqueue_position.compare_exchange_weak(position, position + 1, std::memory_order_relaxed)) {
+                break;
+            }
+        } else if (difference < 0) {
+            return false;
+        } else {
+            position = enqueue_position.load(std::memory_order_relaxed);
+        }
+    }
+
+    slot->value = std::move(value);
+    slot->sequence.store(position + 1, std::memory_order_release);
+    return true;
+}
+
+template <typename T>
+std::optional<T> MpscRing<T>::tryPop()
+{
+    Slot& slot = slots[dequeue_position & mask];
+    if (slot.sequence.load(std::memory_order_acquire) != dequeue_position + 1) {
+        return std::nullopt;
+    }
+
+    std::optional<T> value = std::move(slot.value);
+    slot.sequence.store(dequeue_position + mask + 1, std::memory_order_release);
+    dequeue_position++;
+    return value;
+}
+
+template <typename T>
+size_t MpscRing<T>::capacity() const
+{
+    return mask + 1;
+}
+
+} // namespace Engine::Log
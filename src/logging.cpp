@@ -1,9 +1,22 @@
 #include <pch.hpp>
 
+#include <array>
+#include <cerrno>
+#include <condition_variable>
 #include <cstring>
+#include <fstream>
 #include <iostream>
+#include <mutex>
+#include <sstream>
+#include <thread>
+#include <unordered_map>
+#include "log_ring.hpp"
 #include "platform.hpp"
 
+#if defined(GAME_PLATFORM_LINUX) || defined(GAME_PLATFORM_OSX)
+#include <unistd.h>
+#endif
+
 #if defined (GAME_COMPILER_GCC)
 #pragma GCC diagnostic push
 #pragma GCC diagnostic ignored "-Wmisleading-indentation"
@@ -22,9 +35,130 @@ namespace Engine::Log {
 
 Logger GLOBAL_LOGGER = Logger();
 
-std::string_view truncate_path(const std::source_location& source)
+constexpr std::array<std::string_view, static_cast<size_t>(Category::Count)> CATEGORY_NAMES = {
+    "general",
+    "render",
+    "resource",
+    "lua",
+    "jobs",
+};
+
+std::string_view categoryName(Category category)
+{
+    return CATEGORY_NAMES[static_cast<size_t>(category)];
+}
+
+std::optional<Category> parseCategory(std::string_view name)
+{
+    for (size_t i = 0; i < CATEGORY_NAMES.size(); i++) {
+        if (CATEGORY_NAMES[i] == name) {
+            return static_cast<Category>(i);
+        }
+    }
+    return std::nullopt;
+}
+
+std::optional<Logger::Severity> parseSeverity(std::string_view name)
+{
+    if (name == "debug") {
+        return Logger::Severity::Debug;
+    } else if (name == "info") {
+        return Logger::Severity::Info;
+    } else if (name == "warning" || name == "warn") {
+        return Logger::Severity::Warning;
+    } else if (name == "error") {
+        return Logger::Severity::Error;
+    }
+    return std::nullopt;
+}
+
+LazyMessage::LazyMessage(std::string message)
+    : text(std::move(message))
+{
+}
+
+LazyMessage::~LazyMessage()
+{
+    reset();
+}
+
+LazyMessage::LazyMessage(LazyMessage&& other) noexcept
+{
+    *this = std::move(other);
+}
+
+LazyMessage& LazyMessage::operator=(LazyMessage&& other) noexcept
+{
+    if (this == &other) {
+        return *this;
+    }
+    reset();
+    operations = other.operations;
+    fmt = other.fmt;
+    text = std::move(other.text);
+    if (other.heap != nullptr) {
+        heap = other.heap;
+    } else if (operations != nullptr) {
+        operations->relocate(storage, other.storage);
+    }
+    other.operations = nullptr;
+    other.heap = nullptr;
+    return *this;
+}
+
+void LazyMessage::reset()
+{
+    if (operations == nullptr) {
+        return;
+    }
+    if (heap != nullptr) {
+        operations->destroyHeap(heap);
+    } else {
+        operations->destroy(storage);
+    }
+    operations = nullptr;
+    heap = nullptr;
+}
+
+const void* LazyMessage::payload() const
+{
+    return heap != nullptr ? heap : storage;
+}
+
+std::string LazyMessage::format() const
+{
+    if (operations == nullptr) {
+        return text;
+    }
+    return operations->format(fmt, payload());
+}
+
+constexpr std::array<Binary::ArgType, 1> TEXT_ARG_TYPES = { Binary::ArgType::String };
+
+std::string_view LazyMessage::formatString() const
+{
+    return fmt;
+}
+
+std::span<const Binary::ArgType> LazyMessage::argTypes() const
+{
+    if (operations == nullptr) {
+        return TEXT_ARG_TYPES;
+    }
+    return operations->arg_types;
+}
+
+void LazyMessage::appendArgs(std::string& out) const
+{
+    if (operations == nullptr) {
+        Binary::appendString(out, text);
+    } else {
+        operations->appendArgs(payload(), out);
+    }
+}
+
+std::string_view truncate_path(const char* full)
 {
-    const char* full = source.file_name();
     const char* src_pos = std::strstr(full, "/src/");
 
     if (src_pos) {
@@ -34,41 +168,312 @@ std::string_view truncate_path(const std::source_location& source)
     }
 }
 
-void Logger::log(Severity severity, const std::string& message, const std::source_location& source)
-{
-    std::string message_prefix = std::format("[{}:{}]", truncate_path(source), source.line());
-    logCustomPrefix(severity, message, message_prefix);
-}
+// Everything needed to produce the line later, the message and prefix are only built when
+// it's written. Source file names are string literals so holding on to the pointer is fine.
 
-void Logger::logCustomPrefix(Severity severity, const std::string& message, const std::string& prefix) 
+struct Record {
+    Logger::Severity severity = Logger::Severity::Info;
+    LazyMessage message;
+    std::string prefix;
+    const char* file = nullptr;
+    uint_least32_t line = 0;
+    uint_least32_t column = 0;
+};
+
+static void writeRecord(std::ostream& out, const Record& record)
 {
-    std::string severity_str;
+    std::string_view severity_str;
     oof::color color;
-    switch (severity) {
-        case Severity::Debug: {
+    switch (record.severity) {
+        case Logger::Severity::Debug: {
             severity_str = "Debug";
             color = { 200, 200, 200 };
             break;
         }
-        case Severity::Info: {
+        case Logger::Severity::Info: {
             severity_str = "Info";
             color = { 79, 255, 40 };
             break;
         }
-        case Severity::Warning: {
+        case Logger::Severity::Warning: {
             severity_str = "Warning";
             color = { 255, 243, 0 };
             break;
         }
-        case Severity::Error: {
+        case Logger::Severity::Error: {
             severity_str = "Error";
             color = { 255, 70, 70 };
             break;
         }
     }
 
-    std::cout << oof::fg_color(color) << prefix << " " << severity_str << ": "
-        << oof::reset_formatting() << message << "\n";
+    out << oof::fg_color(color);
+    if (record.file != nullptr) {
+        out << "[" << truncate_path(record.file) << ":" << record.line << "]";
+    } else {
+        out << record.prefix;
+    }
+    out << " " << severity_str << ": " << oof::reset_formatting() << record.message.format() << "\n";
+}
+
+// Writes straight to the file descriptor, a whole batch at a time
+
+static void writeOut(std::string_view data)
+{
+#if defined(GAME_PLATFORM_LINUX) || defined(GAME_PLATFORM_OSX)
+    while (!data.empty()) {
+        const ssize_t written = ::write(STDOUT_FILENO, data.data(), data.size());
+        if (written < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            return;
+        }
+        data.remove_prefix(static_cast<size_t>(written));
+    }
+#else
+    std::cout.write(data.data(), static_cast<std::streamsize>(data.size()));
+    std::cout.flush();
+#endif
+}
+
+// Turns records into the layout from log_binary.hpp, describing each call site the first
+// time it shows up. Custom prefix records all share one site per severity.
+
+class BinaryEncoder {
+public:
+    void encode(std::string& out, const Record& record)
+    {
+        const SiteKey key { record.file, record.line, record.column, record.severity };
+        const auto [site, inserted] = sites.try_emplace(key, static_cast<uint32_t>(sites.size()));
+        if (inserted) {
+            encodeSite(out, site->second, record);
+        }
+
+        out.push_back(Binary::MESSAGE_RECORD);
+        Binary::appendValue(out, site->second);
+        if (record.file == nullptr) {
+            Binary::appendString(out, record.prefix);
+        }
+        record.message.appendArgs(out);
+    }
+
+private:
+    struct SiteKey {
+        const char* file;
+        uint_least32_t line;
+        uint_least32_t column;
+        Logger::Severity severity;
+
+        bool operator==(const SiteKey&) const = default;
+    };
+
+    struct SiteKeyHash {
+        size_t operator()(const SiteKey& key) const
+        {
+            size_t hash = std::hash<const char*>()(key.file);
+            hash = hash * 31 + key.line;
+            hash = hash * 31 + key.column;
+            return hash * 31 + static_cast<size_t>(key.severity);
+        }
+    };
+
+    static void encodeSite(std::string& out, uint32_t id, const Record& record)
+    {
+        const bool custom_prefix = record.file == nullptr;
+        const std::span<const Binary::ArgType> arg_types = record.message.argTypes();
+
+        out.push_back(Binary::SITE_RECORD);
+        Binary::appendValue(out, id);
+        Binary::appendValue(out, static_cast<uint8_t>(record.severity));
+        Binary::appendValue(out, custom_prefix ? Binary::CUSTOM_PREFIX : uint8_t { 0 });
+        Binary::appendValue(out, static_cast<uint32_t>(record.line));
+        Binary::appendString(out, custom_prefix ? std::string_view() : truncate_path(record.file));
+        Binary::appendString(out, record.message.formatString());
+        Binary::appendValue(out, static_cast<uint8_t>(arg_types.size() + (custom_prefix ? 1 : 0)));
+        if (custom_prefix) {
+            Binary::appendValue(out, Binary::ArgType::String);
+        }
+        for (Binary::ArgType type : arg_types) {
+            Binary::appendValue(out, type);
+        }
+    }
+
+    std::unordered_map<SiteKey, uint32_t, SiteKeyHash> sites;
+};
+
+class AsyncBackend {
+public:
+    AsyncBackend(size_t capacity, Logger::OverflowPolicy policy, const std::filesystem::path& binary_path)
+        : queue(capacity), policy(policy)
+    {
+        if (!binary_path.empty()) {
+            binary_file.open(binary_path, std::ios::binary);
+            if (binary_file) {
+                binary_file.write(Binary::MAGIC.data(), Binary::MAGIC.size());
+                binary_file.write(reinterpret_cast<const char*>(&Binary::VERSION), sizeof(Binary::VERSION));
+                encoder.emplace();
+                writeRecord(std::cout, { Logger::Severity::Info, LazyMessage(std::format("Writing binary log to \"{}\"", binary_path.string())), "[logging]" });
+            } else {
+                writeRecord(std::cout, { Logger::Severity::Error, LazyMessage(std::format("Failed to open binary log \"{}\", logging text instead", binary_path.string())), "[logging]" });
+            }
+        }
+
+        // Anything already sitting in cout's buffer has to come out before our writes
+        std::cout.flush();
+        writer = std::thread(&AsyncBackend::writerLoop, this);
+    }
+
+    ~AsyncBackend()
+    {
+        {
+            std::lock_guard lock(mutex);
+            running = false;
+        }
+        condition.notify_one();
+        writer.join();
+    }
+
+    DELETE_COPY(AsyncBackend);
+    DELETE_MOVE(AsyncBackend);
+
+    void submit(Record&& record)
+    {
+        while (!queue.tryPush(std::move(record))) {
+            if (policy == Logger::OverflowPolicy::Drop) {
+                dropped.fetch_add(1, std::memory_order_relaxed);
+                return;
+            }
+            condition.notify_one();
+            std::this_thread::yield();
+        }
+        condition.notify_one();
+    }
+
+private:
+    constexpr static auto IDLE_WAIT = std::chrono::milliseconds(5);
+
+    void writerLoop()
+    {
+        std::ostringstream batch;
+        std::string binary_batch;
+        size_t reported_dropped = 0;
+
+        auto write = [&](const Record& record) {
+            if (encoder) {
+                encoder->encode(binary_batch, record);
+            } else {
+                writeRecord(batch, record);
+            }
+        };
+
+        while (true) {
+            batch.str("");
+            binary_batch.clear();
+            size_t count = 0;
+            while (std::optional<Record> record = queue.tryPop()) {
+                write(*record);
+                // Keeps a burst from growing the batch forever
+                if (++count == queue.capacity()) {
+                    break;
+                }
+            }
+
+            const size_t total_dropped = dropped.load(std::memory_order_relaxed);
+            if (total_dropped != reported_dropped) {
+                write({ Logger::Severity::Warning, LazyMessage(std::format("Dropped {} log messages, queue was full", total_dropped - reported_dropped)), "[logging]" });
+                reported_dropped = total_dropped;
+            }
+
+            if (batch.tellp() > 0) {
+                writeOut(batch.view());
+                continue;
+            }
+            if (!binary_batch.empty()) {
+                binary_file.write(binary_batch.data(), static_cast<std::streamsize>(binary_batch.size()));
+                continue;
+            }
+
+            std::unique_lock lock(mutex);
+            if (!running) {
+                break;
+            }
+            condition.wait_for(lock, IDLE_WAIT);
+        }
+    }
+
+    MpscRing<Record> queue;
+    Logger::OverflowPolicy policy;
+    std::atomic<size_t> dropped = 0;
+
+    // Only set when writing a binary log, otherwise text goes to stdout
+    std::ofstream binary_file;
+    std::optional<BinaryEncoder> encoder;
+
+    std::mutex mutex;
+    std::condition_variable condition;
+    bool running = true;
+    std::thread writer;
+};
+
+Logger::~Logger()
+{
+    stopAsync();
+}
+
+void Logger::startAsync(size_t capacity, OverflowPolicy policy, const std::filesystem::path& binary_path)
+{
+    if (backend.load(std::memory_order_acquire) != nullptr) {
+        return;
+    }
+    backend.store(new AsyncBackend(capacity, policy, binary_path), std::memory_order_release);
+}
+
+void Logger::stopAsync()
+{
+    delete backend.exchange(nullptr, std::memory_order_acq_rel);
 }
 
+void Logger::setLevel(Category category, Severity severity)
+{
+    levels[static_cast<size_t>(category)].store(severity, std::memory_order_relaxed);
 }
+
+void Logger::setLevel(Severity severity)
+{
+    for (auto& level : levels) {
+        level.store(severity, std::memory_order_relaxed);
+    }
+}
+
+Logger::Severity Logger::getLevel(Category category) const
+{
+    return levels[static_cast<size_t>(category)].load(std::memory_order_relaxed);
+}
+
+void Logger::log(Severity severity, const std::string& message, const std::source_location& source)
+{
+    log(severity, LazyMessage(message), source);
+}
+
+void Logger::log(Severity severity, LazyMessage&& message, const std::source_location& source)
+{
+    Record record { severity, std::move(message), {}, source.file_name(), source.line(), source.column() };
+    if (AsyncBackend* async = backend.load(std::memory_order_acquire)) {
+        async->submit(std::move(record));
+    } else {
+        writeRecord(std::cout, record);
+    }
+}
+
+void Logger::logCustomPrefix(Severity severity, const std::string& message, const std::string& prefix) 
+{
+    Record record { severity, LazyMessage(message), prefix };
+    if (AsyncBackend* async = backend.load(std::memory_order_acquire)) {
+        async->submit(std::move(record));
+    } else {
+        writeRecord(std::cout, record);
+    }
+}
+
+} // namespace Engine::Log
@@ -1,11 +1,157 @@
 #pragma once
 
+#include "constructors.hpp"
+#include "log_binary.hpp"
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <filesystem>
 #include <format>
+#include <new>
+#include <optional>
 #include <source_location>
+#include <span>
 #include <string>
+#include <string_view>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+// Anything below this level is compiled out entirely, 0 debug, 1 info, 2 warning, 3 error.
+// Release builds drop debug messages unless told otherwise.
+#if !defined(GAME_LOG_MIN_LEVEL)
+#if defined(NDEBUG)
+#define GAME_LOG_MIN_LEVEL 1
+#else
+#define GAME_LOG_MIN_LEVEL 0
+#endif
+#endif
 
 namespace Engine::Log {
 
+class AsyncBackend;
+
+// Which part of the engine a message comes from, each one has its own runtime level
+enum class Category {
+    General,
+    Render,
+    Resource,
+    Lua,
+    Jobs,
+    Count,
+};
+
+std::string_view categoryName(Category category);
+std::optional<Category> parseCategory(std::string_view name);
+
+// A format string and copies of its arguments, formatting only happens when something
+// asks for the text. That way a message that ends up filtered or dropped never pays
+// for std::format, and the async backend formats on its own thread instead of the
+// caller's. Anything string like gets copied into a std::string since views and char
+// pointers might not outlive the call.
+
+template <typename T>
+using CapturedArg = std::conditional_t<
+    std::is_convertible_v<const std::decay_t<T>&, std::string_view>,
+    std::string,
+    std::decay_t<T>
+>;
+
+class LazyMessage {
+public:
+    LazyMessage() = default;
+    explicit LazyMessage(std::string message);
+    template <typename... Args>
+    explicit LazyMessage(std::format_string<Args...> fmt, Args&&... args);
+    ~LazyMessage();
+    LazyMessage(LazyMessage&& other) noexcept;
+    LazyMessage& operator=(LazyMessage&& other) noexcept;
+    DELETE_COPY(LazyMessage);
+
+    std::string format() const;
+
+    // What the binary sink needs instead of the text. A message built from an already
+    // formatted string looks like "{}" with that string as its only argument.
+    std::string_view formatString() const;
+    std::span<const Binary::ArgType> argTypes() const;
+    void appendArgs(std::string& out) const;
+
+private:
+    // Fits a handful of numbers and a couple of strings without touching the heap
+    constexpr static size_t INLINE_SIZE = 128;
+
+    template <typename... Captured>
+    using Payload = std::tuple<Captured...>;
+
+    template <typename... Captured>
+    constexpr static std::array<Binary::ArgType, sizeof...(Captured)> ARG_TYPES = { Binary::argType<Captured>()... };
+
+    struct Operations {
+        std::string (*format)(std::string_view fmt, const void* payload);
+        void (*appendArgs)(const void* payload, std::string& out);
+        std::span<const Binary::ArgType> arg_types;
+        // Move constructs into uninitialized storage and destroys the source
+        void (*relocate)(void* destination, void* source);
+        void (*destroy)(void* payload);
+        void (*destroyHeap)(void* payload);
+    };
+
+    template <typename... Captured>
+    static std::string formatPayload(std::string_view fmt, const void* payload)
+    {
+        return std::apply([&](const auto&... args) {
+            return std::vformat(fmt, std::make_format_args(args...));
+        }, *static_cast<const Payload<Captured...>*>(payload));
+    }
+
+    template <typename... Captured>
+    static void appendPayloadArgs(const void* payload, std::string& out)
+    {
+        std::apply([&](const auto&... args) {
+            (Binary::appendArg(out, args), ...);
+        }, *static_cast<const Payload<Captured...>*>(payload));
+    }
+
+    template <typename... Captured>
+    constexpr static Operations OPERATIONS = {
+        &formatPayload<Captured...>,
+        &appendPayloadArgs<Captured...>,
+        ARG_TYPES<Captured...>,
+        [](void* destination, void* source) {
+            using P = Payload<Captured...>;
+            new (destination) P(std::move(*static_cast<P*>(source)));
+            static_cast<P*>(source)->~P();
+        },
+        [](void* payload) {
+            using P = Payload<Captured...>;
+            static_cast<P*>(payload)->~P();
+        },
+        [](void* payload) { delete static_cast<Payload<Captured...>*>(payload); },
+    };
+
+    const void* payload() const;
+    void reset();
+
+    const Operations* operations = nullptr;
+    std::string_view fmt = "{}";
+    void* heap = nullptr;
+    std::string text;
+    alignas(std::max_align_t) unsigned char storage[INLINE_SIZE];
+};
+
+template <typename... Args>
+LazyMessage::LazyMessage(std::format_string<Args...> fmt, Args&&... args)
+    : fmt(fmt.get())
+{
+    using P = Payload<CapturedArg<Args>...>;
+    if constexpr (sizeof(P) <= INLINE_SIZE && alignof(P) <= alignof(std::max_align_t)) {
+        new (storage) P(std::forward<Args>(args)...);
+    } else {
+        heap = new P(std::forward<Args>(args)...);
+    }
+    operations = &OPERATIONS<CapturedArg<Args>...>;
+}
+
 class Logger {
 public:
     enum class Severity {
@@ -14,14 +160,69 @@ public:
         Warning,
         Error,
     };
+
+    // What callers do when the async queue is full
+    enum class OverflowPolicy {
+        Drop,
+        Block,
+    };
+
+    constexpr static size_t DEFAULT_QUEUE_CAPACITY = 8192;
+
+    ~Logger();
+
     void log(Severity severity, const std::string& message, const std::source_location& source);
+    void log(Severity severity, LazyMessage&& message, const std::source_location& source);
     void logCustomPrefix(Severity severity, const std::string& message, const std::string& prefix);
+
+    // Runtime filter on top of GAME_LOG_MIN_LEVEL, everything starts out at Debug
+    void setLevel(Category category, Severity severity);
+    void setLevel(Severity severity);
+    Severity getLevel(Category category) const;
+    bool shouldLog(Category category, Severity severity) const
+    {
+        return severity >= levels[static_cast<size_t>(category)].load(std::memory_order_relaxed);
+    }
+
+    // Hands messages to a background thread that formats and writes them in batches,
+    // until this is called everything is written on the calling thread. Both of these
+    // should only be called while no other thread is logging. With a binary_path the
+    // messages go there in the log_binary.hpp layout instead of stdout as text.
+    void startAsync(
+        size_t capacity = DEFAULT_QUEUE_CAPACITY,
+        OverflowPolicy policy = OverflowPolicy::Drop,
+        const std::filesystem::path& binary_path = {}
+    );
+    // Writes out whatever is still queued and goes back to writing synchronously
+    void stopAsync();
+
+private:
+    std::atomic<AsyncBackend*> backend = nullptr;
+    std::array<std::atomic<Severity>, static_cast<size_t>(Category::Count)> levels {};
 };
 
 extern Logger GLOBAL_LOGGER;
 
+constexpr Logger::Severity COMPILE_TIME_MIN_LEVEL = static_cast<Logger::Severity>(GAME_LOG_MIN_LEVEL);
+
+std::optional<Logger::Severity> parseSeverity(std::string_view name);
+
+// Both checks happen before the arguments are captured, a filtered message costs a
+// relaxed load and one compiled out costs nothing
+
+template <Logger::Severity severity, typename... Args>
+void emit(Category category, const std::source_location& source, std::format_string<Args...> fmt, Args&&... args)
+{
+    if constexpr (severity >= COMPILE_TIME_MIN_LEVEL) {
+        if (GLOBAL_LOGGER.shouldLog(category, severity)) {
+            GLOBAL_LOGGER.log(severity, LazyMessage(fmt, std::forward<Args>(args)...), source);
+        }
+    }
+}
+
 // All of these functions have a weird thing under them that basically helps the templates
-// deduce properly otherwise the source location part messes it up really bad
+// deduce properly otherwise the source location part messes it up really bad. Passing a
+// Category first files the message under it, otherwise it goes under General.
 
 template <typename... Args>
 struct debug {
@@ -31,12 +232,23 @@ struct debug {
         std::source_location source = std::source_location::current()
     )
     {
-        std::string message = std::format(fmt, std::forward<Args>(args)...);
-        GLOBAL_LOGGER.log(Logger::Severity::Debug, message, source);
+        emit<Logger::Severity::Debug>(Category::General, source, fmt, std::forward<Args>(args)...);
+    }
+
+    debug(
+        Category category,
+        std::format_string<Args...> fmt,
+        Args&&... args,
+        std::source_location source = std::source_location::current()
+    )
+    {
+        emit<Logger::Severity::Debug>(category, source, fmt, std::forward<Args>(args)...);
     }
 };
 template <typename... Args>
 debug(std::format_string<Args...>, Args&&...) -> debug<Args...>;
+template <typename... Args>
+debug(Category, std::format_string<Args...>, Args&&...) -> debug<Args...>;
 
 template <typename... Args>
 struct info {
@@ -46,12 +258,23 @@ struct info {
         std::source_location source = std::source_location::current()
     )
     {
-        std::string message = std::format(fmt, std::forward<Args>(args)...);
-        GLOBAL_LOGGER.log(Logger::Severity::Info, message, source);
+        emit<Logger::Severity::Info>(Category::General, source, fmt, std::forward<Args>(args)...);
+    }
+
+    info(
+        Category category,
+        std::format_string<Args...> fmt,
+        Args&&... args,
+        std::source_location source = std::source_location::current()
+    )
+    {
+        emit<Logger::Severity::Info>(category, source, fmt, std::forward<Args>(args)...);
     }
 };
 template <typename... Args>
 info(std::format_string<Args...>, Args&&...) -> info<Args...>;
+template <typename... Args>
+info(Category, std::format_string<Args...>, Args&&...) -> info<Args...>;
 
 template <typename... Args>
 struct warn {
@@ -61,12 +284,23 @@ struct warn {
         std::source_location source = std::source_location::current()
     )
     {
-        std::string message = std::format(fmt, std::forward<Args>(args)...);
-        GLOBAL_LOGGER.log(Logger::Severity::Warning, message, source);
+        emit<Logger::Severity::Warning>(Category::General, source, fmt, std::forward<Args>(args)...);
+    }
+
+    warn(
+        Category category,
+        std::format_string<Args...> fmt,
+        Args&&... args,
+        std::source_location source = std::source_location::current()
+    )
+    {
+        emit<Logger::Severity::Warning>(category, source, fmt, std::forward<Args>(args)...);
     }
 };
 template <typename... Args>
 warn(std::format_string<Args...>, Args&&...) -> warn<Args...>;
+template <typename... Args>
+warn(Category, std::format_string<Args...>, Args&&...) -> warn<Args...>;
 
 template <typename... Args>
 struct error {
@@ -76,11 +310,22 @@ struct error {
         std::source_location source = std::source_location::current()
     )
     {
-        std::string message = std::format(fmt, std::forward<Args>(args)...);
-        GLOBAL_LOGGER.log(Logger::Severity::Error, message, source);
+        emit<Logger::Severity::Error>(Category::General, source, fmt, std::forward<Args>(args)...);
+    }
+
+    error(
+        Category category,
+        std::format_string<Args...> fmt,
+        Args&&... args,
+        std::source_location source = std::source_location::current()
+    )
+    {
+        emit<Logger::Severity::Error>(category, source, fmt, std::forward<Args>(args)...);
     }
 };
 template <typename... Args>
 error(std::format_string<Args...>, Args&&...) -> error<Args...>;
+template <typename... Args>
+error(Category, std::format_string<Args...>, Args&&...) -> error<Args...>;
 
 } // namespace Engine::Log
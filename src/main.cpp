@@ -2,22 +2,37 @@
 #include <pch.hpp>
 
 #include <imgui.h>
-#include <backends/imgui_impl_sdl2.h>
 #include <backends/imgui_impl_opengl3.h>
 
 #include "engine/sprite.hpp"
+#include "engine/collision.hpp"
+#include "engine/ecs.hpp"
+#include "engine/kinematics.hpp"
+#include "engine/camera.hpp"
 #include "engine/lua.hpp"
 #include "engine/keycodes.hpp"
 #include "engine/debug.hpp"
+#include "engine/timestep.hpp"
+#include "engine/pipeline.hpp"
+#include "engine/profiler.hpp"
+#include "engine/frame_stats.hpp"
+#include "engine/input_log.hpp"
+#include "engine/ui_input.hpp"
+#include "engine/jobs/job_system.hpp"
 #include "gfx/window.hpp"
 #include "gfx/renderer.hpp"
+#include "gfx/gpu_timer.hpp"
 #include "resource/resource_manager.hpp"
 #include "resource/lua_source.hpp"
 #include "resource/shader.hpp"
+#include "launch_options.hpp"
 
 #include <glm/ext.hpp>
 
+#include <algorithm>
 #include <cassert>
+#include <chrono>
+#include <fstream>
 
 void handleEvent(SDL_Event& e, Engine::Lua& lua, Engine::DebugContext& debug) {
     if (e.key.repeat != 0) { // ignore repeat signals, OS dependent
@@ -49,66 +64,251 @@ void handleEvent(SDL_Event& e, Engine::Lua& lua, Engine::DebugContext& debug) {
     }
 }
 
-void renderLoop(
+void renderFrame(
+    const Engine::RenderSnapshot& frame,
+    Engine::Window& window,
+    Engine::Renderer& renderer,
+    Engine::SpriteManager& sprite_manager,
+    Engine::DebugContext& debug,
+    Engine::GpuTimer& gpu_timer,
+    const Engine::Shader& shader
+)
+{
+    PROFILE_SCOPE("RenderFrame");
+
+    renderer.setViewport(
+        static_cast<size_t>(frame.viewport.x),
+        static_cast<size_t>(frame.viewport.y)
+    );
+    shader.setUniform("projection", frame.projection);
+
+    {
+        PROFILE_SCOPE("ImGui::NewFrame");
+        ImGui_ImplOpenGL3_NewFrame();
+        Engine::applyUiInput(frame.ui_input, frame.delta_time);
+        ImGui::NewFrame();
+        
+        debug.tryRender(frame.delta_time);
+    }
+
+    gpu_timer.beginFrame();
+    renderer.clearBackground();
+    gpu_timer.mark("Clear");
+    sprite_manager.draw(frame, renderer);
+    renderer.flush();
+    gpu_timer.mark("Sprites");
+    {
+        PROFILE_SCOPE("ImGui::Render");
+        ImGui::Render();
+        ImGui_ImplOpenGL3_RenderDrawData(ImGui::GetDrawData());
+    }
+    gpu_timer.mark("ImGui");
+    gpu_timer.endFrame();
+    {
+        PROFILE_SCOPE("Window::swapBuffers");
+        window.swapBuffers();
+    }
+}
+
+// Returns how many frames ran
+uint64_t renderLoop(
+    const Engine::LaunchOptions& options,
     Engine::Lua& lua,
     Engine::Window& window,
     Engine::Renderer& renderer,
     Engine::ResourceManager& resource_manager,
     Engine::SpriteManager& sprite_manager,
+    Engine::CollisionWorld& collision,
+    Engine::KinematicsSystem& kinematics,
+    Engine::Camera& camera,
     Engine::DebugContext& debug,
+    Engine::GpuTimer& gpu_timer,
+    Engine::FrameStats& frame_stats,
+    Engine::FixedTimestep& timestep,
     const Engine::Shader& shader
 )
 {
+    Engine::GLOBAL_PROFILER.setThreadName("Simulation");
+
+    // Only the render stage touches GL from here on, it runs on the pipeline's thread
+    Engine::FramePipeline pipeline(window, [&](const Engine::RenderSnapshot& frame) {
+        renderFrame(frame, window, renderer, sprite_manager, debug, gpu_timer, shader);
+    });
+
     float delta_time = 0;
 
     uint64_t delta_time_now = SDL_GetPerformanceCounter();
     uint64_t delta_time_last = 0;
 
+    std::optional<Engine::InputRecorder> recorder;
+    if (options.record_path) {
+        recorder.emplace(*options.record_path);
+    }
+    std::optional<Engine::InputReplay> replay;
+    if (options.replay_path) {
+        replay.emplace(*options.replay_path);
+    }
+
+    uint64_t frames = 0;
     bool loop = true;
     while (loop) {
         delta_time_last = delta_time_now;
         delta_time_now = SDL_GetPerformanceCounter();
         delta_time = ((delta_time_now - delta_time_last) * 1000) / static_cast<float>(SDL_GetPerformanceFrequency()) / 1000.f;
+        // Stats always get the real frame time, the simulation gets the fixed one if set
+        frame_stats.record(delta_time);
+        if (options.fixed_delta_time) {
+            delta_time = *options.fixed_delta_time;
+        }
 
-        SDL_Event e;
-        while (SDL_PollEvent(&e)) {
-            ImGui_ImplSDL2_ProcessEvent(&e);
-            if (e.type == SDL_QUIT) {
-                loop = false;
+        std::optional<Engine::InputReplay::Frame> replayed;
+        if (replay) {
+            replayed = replay->nextFrame();
+            if (!replayed) {
+                break;
             }
-            handleEvent(e, lua, debug);
+            delta_time = replayed->delta_time;
+        }
+        if (recorder) {
+            recorder->beginFrame(delta_time);
         }
 
-        const glm::vec2 window_size = window.getSize();
-        const glm::mat4 projection = glm::ortho(
-            -(window_size.x / 2),
-            window_size.x / 2,
-            -(window_size.y / 2),
-            window_size.y / 2,
-            -1.f, 1.f
-        );
-        shader.setUniform("projection", projection);
+        Engine::RenderSnapshot& frame = pipeline.beginFrame();
 
-        lua.fireBuiltinEvent("OnFrameStep", delta_time);
+        {
+            PROFILE_SCOPE("PollEvents");
+            SDL_Event e;
+            while (SDL_PollEvent(&e)) {
+                // Live input is ignored during a replay, except for closing the window
+                if (replayed && e.type != SDL_QUIT) {
+                    continue;
+                }
+                frame.ui_input.events.push_back(e);
+                if (e.type == SDL_QUIT) {
+                    loop = false;
+                }
+                if (recorder) {
+                    recorder->recordEvent(e);
+                }
+                handleEvent(e, lua, debug);
+            }
 
-        ImGui_ImplOpenGL3_NewFrame();
-        ImGui_ImplSDL2_NewFrame();
-        ImGui::NewFrame();
-        
-        debug.tryRender(delta_time);
+            if (replayed) {
+                for (SDL_Event& replayed_event : replayed->events) {
+                    frame.ui_input.events.push_back(replayed_event);
+                    if (replayed_event.type == SDL_QUIT) {
+                        loop = false;
+                    }
+                    handleEvent(replayed_event, lua, debug);
+                }
+            }
+        }
 
-        renderer.clearBackground();
-        sprite_manager.render();
-        ImGui::Render();
-        ImGui_ImplOpenGL3_RenderDrawData(ImGui::GetDrawData());
-        window.swapBuffers();
+        timestep.advance(delta_time);
+        while (timestep.step()) {
+            PROFILE_SCOPE("OnFixedStep");
+            sprite_manager.beginFixedStep();
+            lua.fireBuiltinEvent("OnFixedStep", timestep.getStep());
+            // Scripts set the inputs above, the movement itself happens here
+            kinematics.step(timestep.getStep());
+            sprite_manager.endFixedStep();
+        }
+
+        {
+            PROFILE_SCOPE("Collision");
+            collision.step();
+            lua.fireCollisionEvents(collision.getEvents());
+            collision.clearEvents();
+        }
+
+        {
+            PROFILE_SCOPE("OnFrameStep");
+            lua.fireBuiltinEvent("OnFrameStep", delta_time);
+        }
+
+        const glm::vec2 window_size = window.getSize();
+        frame.viewport = window_size;
+        frame.ui_input.display_size = window_size;
+        if (window_size.x > 0.f && window_size.y > 0.f) {
+            frame.ui_input.framebuffer_scale = window.getDrawableSize() / window_size;
+        }
+        frame.projection = camera.getViewProjection(window_size);
+        frame.delta_time = delta_time;
+        sprite_manager.setCullBounds(camera.getVisibleBounds(window_size));
+        sprite_manager.pack(frame, timestep.getAlpha());
+
+        pipeline.submitFrame();
 
         lua.gc();
+
+        Engine::GLOBAL_PROFILER.endFrame();
+
+        frames++;
+        if (options.frame_count != 0 && frames >= options.frame_count) {
+            loop = false;
+        }
     }
+
+    return frames;
 }
 
-int main()
+void writeTimingReport(
+    const std::filesystem::path& path,
+    const Engine::LaunchOptions& options,
+    const Engine::FrameStats& frame_stats,
+    uint64_t frames,
+    double wall_time
+)
+{
+    std::ofstream file(path);
+    if (!file) {
+        Engine::Log::error("Failed to open {} for writing the timing report", path.string());
+        return;
+    }
+
+    const Engine::FrameStats::Summary summary = frame_stats.getSummary();
+    file << "{\n";
+    file << std::format("  \"frames\": {},\n", frames);
+    file << std::format("  \"wall_time_seconds\": {:.6f},\n", wall_time);
+    file << std::format("  \"headless\": {},\n", options.headless);
+    if (options.fixed_delta_time) {
+        file << std::format("  \"fixed_delta_time\": {:.6f},\n", *options.fixed_delta_time);
+    } else {
+        file << "  \"fixed_delta_time\": null,\n";
+    }
+    file << std::format("  \"entry_script\": \"{}\",\n", Engine::escapeJson(options.entry_script.generic_string()));
+    file << "  \"frame_time_ms\": {\n";
+    file << std::format("    \"samples\": {},\n", summary.count);
+    file << std::format("    \"min\": {:.4f},\n", summary.min);
+    file << std::format("    \"avg\": {:.4f},\n", summary.average);
+    file << std::format("    \"p50\": {:.4f},\n", summary.p50);
+    file << std::format("    \"p95\": {:.4f},\n", summary.p95);
+    file << std::format("    \"p99\": {:.4f},\n", summary.p99);
+    file << std::format("    \"max\": {:.4f}\n", summary.max);
+    file << "  },\n";
+    file << std::format("  \"hitch_threshold_ms\": {:.2f},\n", frame_stats.getHitchThreshold());
+    file << std::format("  \"hitches\": {}\n", frame_stats.getHitchCount());
+    file << "}\n";
+
+    Engine::Log::info("Wrote timing report for {} frames to {}", frames, path.string());
+}
+
+int main(int argc, char** argv)
 { 
+    const Engine::LaunchOptions options = Engine::parseLaunchOptions(argc, argv);
+    for (const auto& [category, severity] : options.log_levels) {
+        if (category) {
+            Engine::Log::GLOBAL_LOGGER.setLevel(*category, severity);
+        } else {
+            Engine::Log::GLOBAL_LOGGER.setLevel(severity);
+        }
+    }
+    Engine::Log::GLOBAL_LOGGER.startAsync(
+        Engine::Log::Logger::DEFAULT_QUEUE_CAPACITY,
+        options.log_overflow,
+        options.log_binary_path.value_or(std::filesystem::path())
+    );
+
     IMGUI_CHECKVERSION();
     ImGui::CreateContext();
     ImGuiIO& io = ImGui::GetIO();
@@ -117,44 +317,79 @@ int main()
     ImGui::StyleColorsDark();
 
     {
-        Engine::Window window;
+        Engine::JobSystem jobs;
+        Engine::Window window(options.headless ? Engine::WindowMode::Headless : Engine::WindowMode::Windowed);
         Engine::Renderer renderer;
         renderer.setViewport(
             static_cast<size_t>(window.getSize().x), 
             static_cast<size_t>(window.getSize().y)
         );
-        window.setRenderer(&renderer);
+        Engine::GpuTimer gpu_timer;
 
         Engine::ResourceManager resource_manager;
         const auto& shader = resource_manager.load<Engine::Shader>("test.shader");
-        const auto& entry_script = resource_manager.load<Engine::LuaSource>("main.lua");
+        const auto& entry_script = resource_manager.load<Engine::LuaSource>(options.entry_script);
 
-        Engine::SpriteManager sprite_manager(shader);
+        Engine::SpriteManager sprite_manager(shader, jobs);
+        Engine::CollisionWorld collision(sprite_manager);
+        Engine::EntityRegistry registry;
+        // Entities own their sprite, it goes away with the component or the entity
+        registry.getPool<Engine::Sprite>().setRemoveHook([](Engine::Entity, Engine::Sprite& sprite) {
+            sprite.destroy();
+        });
+        Engine::KinematicsSystem kinematics(registry, sprite_manager);
+        Engine::FixedTimestep timestep;
+        Engine::Camera camera;
 
-        Engine::Lua lua(sprite_manager);
+        Engine::Lua lua(sprite_manager, collision, registry, resource_manager, camera, timestep, window);
         lua.registerTypes<
             glm::vec2,
             glm::vec3,
             Engine::Sprite,
+            Engine::SpriteBatch,
+            Engine::AtlasRegion,
+            Engine::Camera,
+            Engine::Kinematics,
+            Engine::FloatBuffer,
             Engine::Event,
             Engine::EventConnection
         >();
         lua.runEntryPoint(entry_script);
 
-        Engine::DebugContext debug;
+        // Long fixed length runs keep every frame so the report covers the whole run
+        Engine::FrameStats frame_stats(std::max<size_t>(static_cast<size_t>(options.frame_count), Engine::FrameStats::DEFAULT_CAPACITY));
+        Engine::DebugContext debug(lua.getProfiler(), gpu_timer, frame_stats, renderer.getQueue());
 
-        renderLoop(
+        const auto start_time = std::chrono::steady_clock::now();
+        const uint64_t frames = renderLoop(
+            options,
             lua,
             window,
             renderer,
             resource_manager,
             sprite_manager,
+            collision,
+            kinematics,
+            camera,
             debug,
+            gpu_timer,
+            frame_stats,
+            timestep,
             shader
         );
+        const std::chrono::duration<double> wall_time = std::chrono::steady_clock::now() - start_time;
+
+        // Headless runs are for automation, always leave a report behind
+        const auto report_path = options.report_path
+            ? options.report_path
+            : (options.headless ? std::optional<std::filesystem::path>("timing_report.json") : std::nullopt);
+        if (report_path) {
+            writeTimingReport(*report_path, options, frame_stats, frames, wall_time.count());
+        }
     }
 
     ImGui::DestroyContext();
+    Engine::Log::GLOBAL_LOGGER.stopAsync();
     
     return 0;
 }
@@ -26,6 +26,12 @@
 #error Unsupported compiler
 #endif
 
+#if defined(__x86_64__) || defined(_M_X64)
+#define GAME_ARCH_X86_64
+#elif defined(__aarch64__) || defined(_M_ARM64)
+#define GAME_ARCH_ARM64
+#endif
+
 #if defined(GAME_COMPILER_CLANG) || defined(GAME_COMPILER_GCC)
 #define GAME_PACKED_STRUCT(name, ...) \
 struct name __VA_ARGS__ __attribute__((__packed__));
@@ -6,12 +6,12 @@ namespace Engine {
 
 LuaSource::LuaSource(const std::filesystem::path& path)
 {
-    Log::info("Attempting to load lua source \"{}\"", path.string());
+    Log::info(Log::Category::Resource, "Attempting to load lua source \"{}\"", path.string());
     
     source = path;
     name = path.filename();
 
-    Log::info("Succesfully loaded lua source \"{}\"", path.string());
+    Log::info(Log::Category::Resource, "Succesfully loaded lua source \"{}\"", path.string());
 }
 
 const std::filesystem::path& LuaSource::getSource() const
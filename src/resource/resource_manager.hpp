@@ -40,9 +40,15 @@ private:
     std::vector<std::unique_ptr<Resource>> resources;
 };
 
+// Loading the same path twice hands back the resource from the first time
+
 template <ResourceType T>
 const T& ResourceManager::load(const std::filesystem::path& path)
 {
+    if (const T* existing = get_helper<T>(path)) {
+        return *existing;
+    }
+
     const ResourceId new_id = resources.size();
     path_to_id[path] = new_id;
 
@@ -63,7 +69,7 @@ const T& ResourceManager::get(const std::filesystem::path& path) const
         return *resource;
     } else {
         const auto type_name = T::RESOURCE_NAME;
-        Log::error("Failed to load resource of type \"{}\" at \"{}\"", type_name, path.string());
+        Log::error(Log::Category::Resource, "Failed to load resource of type \"{}\" at \"{}\"", type_name, path.string());
         std::exit(EXIT_FAILURE);
     }
 }
@@ -3,7 +3,9 @@
 #include "shader.hpp"
 #include "../gfx/render_backend.hpp"
 #include "../gfx/opengl.hpp"
+#include "../gfx/gl_state.hpp"
 #include "gfx/buffer.hpp"
+#include <algorithm>
 #include <fstream>
 #include <sstream>
 
@@ -11,11 +13,11 @@ namespace Engine {
 
 Shader::Shader(const std::filesystem::path& path)
 {
-    Log::info("Attempting to load shader \"{}\"", path.string());
+    Log::info(Log::Category::Resource, "Attempting to load shader \"{}\"", path.string());
 
     std::ifstream file(path);
     if (!file) {
-        Log::error("Shader \"{}\" could not be found or opened", path.string());
+        Log::error(Log::Category::Resource, "Shader \"{}\" could not be found or opened", path.string());
         return;
     }
     
@@ -28,15 +30,15 @@ Shader::Shader(const std::filesystem::path& path)
     if (auto maybe_data = preProcessShader(full_shader)) {
         data = *maybe_data;
     } else {
-        Log::error("Failed to process shader \"{}\"", path.string());
+        Log::error(Log::Category::Resource, "Failed to process shader \"{}\"", path.string());
         return;
     }
 
     const char* vert_cstr = data.vert.c_str();
     const char* frag_cstr = data.frag.c_str();
 
-    Log::debug("Vert for \"{}\" -> \n{}", path.string(), vert_cstr);
-    Log::debug("Frag for \"{}\" -> \n{}", path.string(), frag_cstr);
+    Log::debug(Log::Category::Resource, "Vert for \"{}\" -> \n{}", path.string(), vert_cstr);
+    Log::debug(Log::Category::Resource, "Frag for \"{}\" -> \n{}", path.string(), frag_cstr);
 
     const GLuint vert = OPENGL_CALL(glCreateShader(GL_VERTEX_SHADER));
     const GLuint frag = OPENGL_CALL(glCreateShader(GL_FRAGMENT_SHADER));
@@ -53,7 +55,7 @@ Shader::Shader(const std::filesystem::path& path)
     if (!compiled) {
         OPENGL_CALL(glGetShaderInfoLog(vert, 512, nullptr, log));
         std::string_view safe_log = log;
-        Log::error("Failed to compile vertex shader for \"{}\" -> \"{}\"", path.string(), safe_log);
+        Log::error(Log::Category::Resource, "Failed to compile vertex shader for \"{}\" -> \"{}\"", path.string(), safe_log);
         return;
     }
     
@@ -61,7 +63,7 @@ Shader::Shader(const std::filesystem::path& path)
     if (!compiled) {
         OPENGL_CALL(glGetShaderInfoLog(frag, 512, nullptr, log));
         std::string_view safe_log = log;
-        Log::error("Failed to compile fragment shader for \"{}\" -> \"{}\"", path.string(), safe_log);
+        Log::error(Log::Category::Resource, "Failed to compile fragment shader for \"{}\" -> \"{}\"", path.string(), safe_log);
         OPENGL_CALL(glDeleteShader(vert));
         return;
     }
@@ -75,7 +77,7 @@ Shader::Shader(const std::filesystem::path& path)
     if (!compiled) {
         OPENGL_CALL(glGetProgramInfoLog(program, 512, nullptr, log));
         std::string_view safe_log = log;
-        Log::error("Failed to link shader program for \"{}\" -> \"{}\"", path.string(), safe_log);
+        Log::error(Log::Category::Resource, "Failed to link shader program for \"{}\" -> \"{}\"", path.string(), safe_log);
         return;
     }
 
@@ -85,13 +87,13 @@ Shader::Shader(const std::filesystem::path& path)
     OPENGL_CALL(glDeleteShader(vert));
     OPENGL_CALL(glDeleteShader(frag));
 
-    Log::info("Successfully loaded shader \"{}\"", path.string());
+    Log::info(Log::Category::Resource, "Successfully loaded shader \"{}\"", path.string());
 }
 
 Shader::~Shader()
 {
     if (program != 0) {
-        OPENGL_CALL(glDeleteProgram(program));
+        GL_STATE.deleteProgram(program);
     }
 }
 
@@ -131,7 +133,19 @@ std::optional<Shader::ShaderData> Shader::preProcessShader(const std::string& fi
 
 void Shader::use() const
 {
-    OPENGL_CALL(glUseProgram(program));
+    GL_STATE.useProgram(program);
+}
+
+unsigned int Shader::getProgram() const
+{
+    return program;
+}
+
+void Shader::setUniform(const std::string& name, int value) const
+{
+    use();
+    GLint location = OPENGL_CALL(glGetUniformLocation(program, name.c_str()));
+    OPENGL_CALL(glUniform1i(location, value)); 
 }
 
 void Shader::setUniform(const std::string& name, float value) const
@@ -162,31 +176,51 @@ void Shader::setUniform(const std::string& name, const glm::mat4& value) const
     OPENGL_CALL(glUniformMatrix4fv(location, 1, GL_FALSE, &value[0][0]));
 }
 
+// Active attributes come back in whatever order the driver likes, the layout has to follow
+// their locations since attribute i gets bound to location i
+
 VertexBufferLayout Shader::getUniformLayout() const
 {
-    VertexBufferLayout layout;
+    struct Attribute {
+        GLint location;
+        GLenum type;
+        GLint size;
+    };
 
     int attrib_count;
     OPENGL_CALL(glGetProgramiv(program, GL_ACTIVE_ATTRIBUTES, &attrib_count));
-    Log::debug("Attrib count {}", attrib_count);
+    Log::debug(Log::Category::Resource, "Attrib count {}", attrib_count);
 
+    std::vector<Attribute> attributes;
     for (int i = 0; i < attrib_count; i++) {
         char name[256];
         GLsizei length;
         int size;
         unsigned int type;
         OPENGL_CALL(glGetActiveAttrib(program, i, sizeof(name), &length, &size, &type, name));
-        Log::debug("Attrib {} of size {}", name, size);
-
-        auto attrib_type = static_cast<AttributeType>(type);
-        switch (attrib_type) {
-        case AttributeType::UInt: layout.push<GLuint>(static_cast<size_t>(size)); break;
-        case AttributeType::Int: layout.push<GLint>(static_cast<size_t>(size)); break;
-        case AttributeType::Float: layout.push<GLfloat>(static_cast<size_t>(size)); break;
-        case AttributeType::Vec2: layout.push<glm::vec2>(static_cast<size_t>(size)); break;
-        case AttributeType::Vec3: layout.push<glm::vec3>(static_cast<size_t>(size)); break;
-        case AttributeType::Mat4: layout.push<glm::mat4>(static_cast<size_t>(size)); break;
-        default: Log::error("Unhandled OpenGL attribute type {}", type); break;
+        // Builtins like gl_VertexID show up here too but don't take a location
+        const GLint location = OPENGL_CALL(glGetAttribLocation(program, name));
+        Log::debug(Log::Category::Resource, "Attrib {} at location {} of size {}", name, location, size);
+        if (location >= 0) {
+            attributes.push_back({ location, type, size });
+        }
+    }
+    std::sort(attributes.begin(), attributes.end(), [](const Attribute& lhs, const Attribute& rhs) {
+        return lhs.location < rhs.location;
+    });
+
+    VertexBufferLayout layout;
+    for (const Attribute& attribute : attributes) {
+        const auto size = static_cast<size_t>(attribute.size);
+        switch (static_cast<AttributeType>(attribute.type)) {
+        case AttributeType::UInt: layout.push<GLuint>(size); break;
+        case AttributeType::Int: layout.push<GLint>(size); break;
+        case AttributeType::Float: layout.push<GLfloat>(size); break;
+        case AttributeType::Vec2: layout.push<glm::vec2>(size); break;
+        case AttributeType::Vec3: layout.push<glm::vec3>(size); break;
+        case AttributeType::Vec4: layout.push<glm::vec4>(size); break;
+        case AttributeType::Mat4: layout.push<glm::mat4>(size); break;
+        default: Log::error(Log::Category::Resource, "Unhandled OpenGL attribute type {}", attribute.type); break;
         }
     }
 
@@ -24,6 +24,8 @@ public:
     constexpr static std::string_view RESOURCE_NAME = "Shader";
     
     void use() const;
+    unsigned int getProgram() const;
+    void setUniform(const std::string& name, int value) const;
     void setUniform(const std::string& name, float value) const;
     void setUniform(const std::string& name, glm::vec2 value) const;
     void setUniform(const std::string& name, const glm::vec3& value) const;
@@ -0,0 +1,65 @@
+#include <pch.hpp>
+
+#include "texture.hpp"
+#include "../platform.hpp"
+
+#if defined(GAME_COMPILER_GCC) || defined(GAME_COMPILER_CLANG)
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wsign-compare"
+#pragma GCC diagnostic ignored "-Wunused-function"
+#pragma GCC diagnostic ignored "-Wmissing-field-initializers"
+#endif
+
+#define STB_IMAGE_IMPLEMENTATION
+#define STBI_ONLY_PNG
+#define STBI_ONLY_JPEG
+#define STBI_ONLY_BMP
+#define STBI_ONLY_TGA
+#include <stb_image.h>
+
+#if defined(GAME_COMPILER_GCC) || defined(GAME_COMPILER_CLANG)
+#pragma GCC diagnostic pop
+#endif
+
+namespace Engine {
+
+Texture::Texture(const std::filesystem::path& path)
+{
+    Log::info(Log::Category::Resource, "Attempting to load texture \"{}\"", path.string());
+
+    int channels = 0;
+    stbi_uc* data = stbi_load(path.string().c_str(), &width, &height, &channels, CHANNELS);
+    if (data == nullptr) {
+        Log::error(Log::Category::Resource, "Failed to load texture \"{}\": {}", path.string(), stbi_failure_reason());
+        width = 0;
+        height = 0;
+        return;
+    }
+
+    pixels.assign(data, data + static_cast<size_t>(width) * static_cast<size_t>(height) * CHANNELS);
+    stbi_image_free(data);
+
+    Log::info(Log::Category::Resource, "Successfully loaded texture \"{}\" ({}x{})", path.string(), width, height);
+}
+
+int Texture::getWidth() const
+{
+    return width;
+}
+
+int Texture::getHeight() const
+{
+    return height;
+}
+
+std::span<const uint8_t> Texture::getPixels() const
+{
+    return pixels;
+}
+
+bool Texture::isValid() const
+{
+    return !pixels.empty();
+}
+
+} // namespace Engine
@@ -0,0 +1,42 @@
+#pragma once
+
+#include "resource.hpp"
+#include "../constructors.hpp"
+#include <cstdint>
+#include <filesystem>
+#include <span>
+#include <string_view>
+#include <vector>
+
+namespace Engine {
+
+class ResourceManager;
+
+// Image decoded into RGBA8 pixels, rows top to bottom. Only lives on the CPU, sprites get
+// it onto the GPU by adding it to a TextureAtlas.
+
+class Texture : public Resource {
+public:
+    DELETE_COPY(Texture);
+    DEFAULT_MOVE(Texture);
+
+    constexpr static std::string_view RESOURCE_NAME = "Texture";
+    constexpr static int CHANNELS = 4;
+
+    int getWidth() const;
+    int getHeight() const;
+    std::span<const uint8_t> getPixels() const;
+    // False if the image couldn't be loaded, the texture is empty then
+    bool isValid() const;
+
+private:
+    friend ResourceManager;
+
+    Texture(const std::filesystem::path& path);
+
+    int width = 0;
+    int height = 0;
+    std::vector<uint8_t> pixels;
+};
+
+} // namespace Engine
@@ -0,0 +1,248 @@
+#include "log_binary.hpp"
+
+#include <array>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <optional>
+#include <string>
+#include <unordered_map>
+#include <variant>
+#include <vector>
+
+// Reads a binary log and prints it the way the text logger would have, minus the colours.
+// Usage: log_decode <binary log>
+
+namespace Binary = Engine::Log::Binary;
+
+using Value = std::variant<bool, char, int32_t, int64_t, uint32_t, uint64_t, float, double, std::string, const void*>;
+
+struct Site {
+    uint8_t severity = 0;
+    uint8_t flags = 0;
+    uint32_t line = 0;
+    std::string file;
+    std::string format;
+    std::vector<Binary::ArgType> arg_types;
+};
+
+class Reader {
+public:
+    explicit Reader(std::istream& in)
+        : in(in)
+    {
+
+    }
+
+    template <typename T>
+    bool read(T& value)
+    {
+        return static_cast<bool>(in.read(reinterpret_cast<char*>(&value), sizeof(T)));
+    }
+
+    bool readString(std::string& text)
+    {
+        uint32_t length = 0;
+        if (!read(length)) {
+            return false;
+        }
+        text.resize(length);
+        return static_cast<bool>(in.read(text.data(), length));
+    }
+
+    std::optional<Value> readArg(Binary::ArgType type)
+    {
+        switch (type) {
+        case Binary::ArgType::Bool: return readAs<bool>();
+        case Binary::ArgType::Char: return readAs<char>();
+        case Binary::ArgType::Int32: return readAs<int32_t>();
+        case Binary::ArgType::Int64: return readAs<int64_t>();
+        case Binary::ArgType::UInt32: return readAs<uint32_t>();
+        case Binary::ArgType::UInt64: return readAs<uint64_t>();
+        case Binary::ArgType::Float: return readAs<float>();
+        case Binary::ArgType::Double: return readAs<double>();
+        case Binary::ArgType::Pointer: {
+            uint64_t address = 0;
+            if (!read(address)) {
+                return std::nullopt;
+            }
+            return reinterpret_cast<const void*>(static_cast<uintptr_t>(address));
+        }
+        case Binary::ArgType::String:
+        case Binary::ArgType::Formatted: {
+            std::string text;
+            if (!readString(text)) {
+                return std::nullopt;
+            }
+            return text;
+        }
+        }
+        return std::nullopt;
+    }
+
+private:
+    template <typename T>
+    std::optional<Value> readAs()
+    {
+        T value {};
+        if (!read(value)) {
+            return std::nullopt;
+        }
+        return value;
+    }
+
+    std::istream& in;
+};
+
+static std::string_view severityName(uint8_t severity)
+{
+    switch (severity) {
+    case 0: return "Debug";
+    case 1: return "Info";
+    case 2: return "Warning";
+    case 3: return "Error";
+    default: return "Unknown";
+    }
+}
+
+// Formats one replacement field on its own. Formatted arguments were turned into strings
+// when they were logged, so a spec meant for the original type might not apply anymore.
+
+static std::string formatField(std::string_view spec, const Value& value)
+{
+    const std::string field = spec.empty() ? "{}" : std::format("{{:{}}}", spec);
+    return std::visit([&](const auto& argument) {
+        try {
+            return std::vformat(field, std::make_format_args(argument));
+        } catch (const std::format_error&) {
+            return std::vformat("{}", std::make_format_args(argument));
+        }
+    }, value);
+}
+
+static std::string formatMessage(std::string_view format, const std::vector<Value>& args)
+{
+    std::string out;
+    size_t next_arg = 0;
+    for (size_t i = 0; i < format.size(); i++) {
+        const char c = format[i];
+        if ((c == '{' || c == '}') && i + 1 < format.size() && format[i + 1] == c) {
+            out.push_back(c);
+            i++;
+            continue;
+        }
+        if (c != '{') {
+            out.push_back(c);
+            continue;
+        }
+
+        const size_t end = format.find('}', i);
+        if (end == std::string_view::npos) {
+            out.append(format.substr(i));
+            break;
+        }
+        const std::string_view field = format.substr(i + 1, end - i - 1);
+        const size_t colon = field.find(':');
+        const std::string_view index_text = field.substr(0, colon);
+        const std::string_view spec = colon == std::string_view::npos ? std::string_view() : field.substr(colon + 1);
+
+        size_t index = next_arg++;
+        if (!index_text.empty()) {
+            index = std::stoul(std::string(index_text));
+        }
+        out.append(index < args.size() ? formatField(spec, args[index]) : "{?}");
+        i = end;
+    }
+    return out;
+}
+
+int main(int argc, char** argv)
+{
+    if (argc != 2) {
+        std::cerr << "Usage: log_decode <binary log>\n";
+        return EXIT_FAILURE;
+    }
+
+    std::ifstream file(argv[1], std::ios::binary);
+    if (!file) {
+        std::cerr << "Failed to open \"" << argv[1] << "\"\n";
+        return EXIT_FAILURE;
+    }
+
+    Reader reader(file);
+    std::array<char, 4> magic {};
+    uint32_t version = 0;
+    if (!reader.read(magic) || magic != Binary::MAGIC || !reader.read(version)) {
+        std::cerr << "\"" << argv[1] << "\" is not a binary log\n";
+        return EXIT_FAILURE;
+    }
+    if (version != Binary::VERSION) {
+        std::cerr << "\"" << argv[1] << "\" is version " << version << ", expected " << Binary::VERSION << "\n";
+        return EXIT_FAILURE;
+    }
+
+    std::unordered_map<uint32_t, Site> sites;
+    uint64_t messages = 0;
+    bool truncated = false;
+    char tag = 0;
+    while (reader.read(tag)) {
+        uint32_t id = 0;
+        if (!reader.read(id)) {
+            truncated = true;
+            break;
+        }
+
+        if (tag == Binary::SITE_RECORD) {
+            Site site;
+            uint8_t arg_count = 0;
+            if (!reader.read(site.severity) || !reader.read(site.flags) || !reader.read(site.line)
+                || !reader.readString(site.file) || !reader.readString(site.format) || !reader.read(arg_count)) {
+                truncated = true;
+                break;
+            }
+            site.arg_types.resize(arg_count);
+            if (!file.read(reinterpret_cast<char*>(site.arg_types.data()), arg_count)) {
+                truncated = true;
+                break;
+            }
+            sites[id] = std::move(site);
+            continue;
+        }
+
+        const auto site = sites.find(id);
+        if (tag != Binary::MESSAGE_RECORD || site == sites.end()) {
+            std::cerr << "Corrupt record after " << messages << " messages\n";
+            return EXIT_FAILURE;
+        }
+
+        std::vector<Value> args;
+        args.reserve(site->second.arg_types.size());
+        for (Binary::ArgType type : site->second.arg_types) {
+            std::optional<Value> value = reader.readArg(type);
+            if (!value) {
+                break;
+            }
+            args.push_back(std::move(*value));
+        }
+        if (args.size() != site->second.arg_types.size()) {
+            truncated = true;
+            break;
+        }
+
+        if (site->second.flags & Binary::CUSTOM_PREFIX) {
+            const std::string prefix = std::get<std::string>(args.front());
+            args.erase(args.begin());
+            std::cout << prefix;
+        } else {
+            std::cout << "[" << site->second.file << ":" << site->second.line << "]";
+        }
+        std::cout << " " << severityName(site->second.severity) << ": " << formatMessage(site->second.format, args) << "\n";
+        messages++;
+    }
+
+    if (truncated) {
+        std::cerr << "Binary log is truncated after " << messages << " messages\n";
+        return EXIT_FAILURE;
+    }
+    return EXIT_SUCCESS;
+}